@@ -0,0 +1,125 @@
+#pragma once
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <chrono>
+#include "solver15.hpp"
+#include "../sliding/batch_expand.hpp"
+
+// ノードをまとめて展開する A* Search
+//
+// A_star_path は 1 ノードずつ取り出して子を差分評価するが、こちらは
+//   1. オープンリストの先頭から f が同じノードを最大 block 個まとめて取り出し
+//   2. sliding::expand_batch で子をすべて SoA のバッファに生成し
+//   3. 状態表で重複（g が小さくならない子）を除いてから
+//   4. 残りの子の h を評価器の evaluate_batch でまとめて求める（マンハッタン距離は AVX2、PDB は表引きを重ねる）
+// 評価器は無矛盾 (consistent) であること。そうなら子の f は親の f 以上なので、同じ f のノードをまとめて閉じても
+// 1 つずつ取り出したときと同じく最適解が得られる（同じ f の中での展開順だけが変わる）。
+
+namespace solver15 {
+
+template <class H = puzzle15::ManhattanHeuristic, class P = puzzle15::Puzzle, TieBreak Tie = TieBreak::Fifo>
+inline SearchResult
+A_star_batch_path(const P& start,
+                  const P& goal,
+                  H heur = H{},
+                  std::size_t block = 64) {
+    static_assert(sliding::is_batch_heuristic_v<H, P>, "H must provide evaluate_batch");
+    using Puzzle = P;
+    using Move = sliding::Move;
+    using Key = typename P::Storage;
+    if (!sliding::is_solvable(start, goal)) return unsolvable_result();
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto elapsed = [&] {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    };
+    std::size_t generated = 0;
+
+    if (start.packed == goal.packed) {
+        return SearchResult{std::make_optional(std::vector<Move>{}), generated, elapsed()};
+    }
+    if (block == 0) block = 1;
+
+    constexpr int MAX_DEPTH = P::Geometry::MAX_DEPTH;
+    static_assert(MAX_DEPTH + 1 <= 255, "g and h are stored as uint8_t in FlatStateTable");
+    BucketPriorityQueue<Puzzle, Tie, true> open(0, MAX_DEPTH + 2, 0, MAX_DEPTH + 2);
+    auto second_key = [](int g, int h) { return Tie == TieBreak::HighG ? g : h; };
+    sliding::FlatStateTable<Key> table(1 << 20);
+
+    uint8_t hstart = 0;
+    heur.evaluate_batch(&start.packed, &start.zero_pos, 1, &hstart);
+    open.push(start, hstart, second_key(0, hstart));
+    {
+        auto& root = *table.insert(start.packed).first;
+        root.g = 0;
+        root.h = hstart;
+    }
+
+    // 取り出したノード（SoA）と、その子
+    std::vector<Key> parent_packed(block);
+    std::vector<uint8_t> parent_zero(block), parent_g(block);
+    std::vector<std::optional<Move>> parent_move(block);
+    sliding::SuccessorBatch<Puzzle> children;
+    std::vector<uint8_t> h_child;
+
+    while (!open.empty()) {
+        // f が同じノードを最大 block 個取り出す（展開済みは飛ばす）
+        const int f_cur = open.top_f();
+        std::size_t n = 0;
+        while (n < block && !open.empty() && open.top_f() == f_cur) {
+            const Puzzle s = open.top();
+            const int g_cur = (Tie == TieBreak::HighG) ? open.top_h() : f_cur - open.top_h();
+            open.pop();
+
+            if (s.packed == goal.packed) {
+                std::vector<Move> path;
+                Puzzle x = s;
+                while (!(x.packed == start.packed)) {
+                    const auto* slot = table.find(x.packed);
+                    path.push_back(*slot->move());
+                    x.undo_move_inplace(x.get(slot->prev_zero), slot->prev_zero);
+                }
+                std::reverse(path.begin(), path.end());
+                return SearchResult{std::make_optional(std::move(path)), generated, elapsed(), {}, table.size()};
+            }
+
+            auto* slot = table.find(s.packed);
+            if (slot->closed()) continue;
+            slot->set_closed();
+            parent_packed[n] = s.packed;
+            parent_zero[n] = s.zero_pos;
+            parent_g[n] = static_cast<uint8_t>(g_cur);
+            parent_move[n] = slot->move();
+            ++n;
+        }
+        if (n == 0) continue;
+
+        // 子をまとめて生成し、直前手の巻き戻しと g が小さくならない子を除く
+        children.clear();
+        sliding::expand_batch<Puzzle>(parent_packed.data(), parent_zero.data(), n, children);
+        children.compact([&](std::size_t i) {
+            const auto& pm = parent_move[children.parent[i]];
+            if (pm && children.move[i] == inverse_move(*pm)) return false;
+            const auto* slot = table.find(children.packed[i]);
+            return !slot || parent_g[children.parent[i]] + 1 < slot->g;
+        });
+
+        // 残った子の h をまとめて求める
+        h_child.resize(children.size());
+        heur.evaluate_batch(children.packed.data(), children.zero.data(), children.size(), h_child.data());
+
+        for (std::size_t i = 0; i < children.size(); ++i) {
+            const int g_child = parent_g[children.parent[i]] + 1;
+            auto [slot, inserted] = table.insert(children.packed[i]);
+            if (!inserted && g_child >= slot->g) continue; // 同じバッチの中の重複
+            slot->assign(g_child, h_child[i], children.move[i], children.old_zero[i]);
+            ++generated;
+            open.push(children.board(i), g_child + h_child[i], second_key(g_child, h_child[i]));
+        }
+    }
+
+    return SearchResult{std::nullopt, generated, elapsed(), {}, table.size()};
+}
+
+} // namespace solver15
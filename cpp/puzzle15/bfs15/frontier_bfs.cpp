@@ -0,0 +1,78 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <climits>
+#include "frontier_bfs15.hpp"
+
+// ディスク上のフロンティア幅優先探索で状態空間を数え上げるドライバ
+// 層ごとの状態数を表示し（作業ディレクトリの counts.csv にも残る）、最後まで進んだら最も遠い状態を書き出す。
+// 途中で止めても、同じ作業ディレクトリを指定すれば続きから再開する。
+//
+// ./bfs <作業ディレクトリ> <4x4|3x4|2x4|3x3> <メモリMB> <最大深さ>
+//   最大深さを省略すると状態空間を最後まで数える（4x4 は 80 層・約 10 兆状態なので、ディスクも時間もかなり要る）
+
+template <int Rows, int Cols>
+static int run(const std::string& dir, std::size_t mem_mb, int max_depth) {
+    bfs15::FrontierBfs<Rows, Cols> bfs(dir, mem_mb);
+    const auto& counts = bfs.counts();
+
+    uint64_t total = 0;
+    for (int d = 0; d <= bfs.depth(); ++d) {
+        total += counts[d];
+        std::cout << "depth " << d << ": " << counts[d] << " (resumed)\n";
+    }
+
+    while (!bfs.finished() && bfs.depth() < max_depth) {
+        auto t0 = std::chrono::steady_clock::now();
+        const uint64_t n = bfs.step();
+        auto t1 = std::chrono::steady_clock::now();
+        total += n;
+        std::cout << "depth " << bfs.depth() << ": " << n << " ("
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << " ms, total " << total
+                  << ")" << std::endl;
+    }
+
+    if (bfs.finished()) {
+        // 空の層の 1 つ手前が最も遠い層（まだ消していない）
+        const int far = bfs.depth() - 1;
+        const std::string path = dir + "/farthest.txt";
+        std::ofstream ofs(path);
+        if (!ofs) {
+            std::cerr << "Failed to open " << path << "\n";
+            return 1;
+        }
+        int shown = 0;
+        bfs.for_each_state(far, [&](const auto& p) {
+            ofs << p.to_string() << "\n\n";
+            if (shown++ < 10) std::cout << p.to_string() << "\n\n"; // 先頭の 10 個だけ表示
+        });
+        std::cout << "Finished: " << total << " states, max depth " << far << " (" << counts[far]
+                  << " states, written to " << path << ")\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <work dir> <4x4|3x4|2x4|3x3> <memory MB> [max depth]\n";
+        return 1;
+    }
+    const std::string dir = argv[1];
+    const std::string shape = argv[2];
+    const std::size_t mem_mb = static_cast<std::size_t>(std::atoll(argv[3]));
+    const int max_depth = argc >= 5 ? std::atoi(argv[4]) : INT_MAX;
+
+    try {
+        if (shape == "4x4") return run<4, 4>(dir, mem_mb, max_depth);
+        if (shape == "3x4") return run<3, 4>(dir, mem_mb, max_depth);
+        if (shape == "2x4") return run<2, 4>(dir, mem_mb, max_depth);
+        if (shape == "3x3") return run<3, 3>(dir, mem_mb, max_depth);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    std::cerr << "Unknown shape: " << shape << " (4x4 / 3x4 / 2x4 / 3x3)\n";
+    return 1;
+}
@@ -0,0 +1,394 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#include "../../sliding/sliding_puzzle.hpp"
+#include "../../sliding/batch_expand.hpp"
+
+// ディスク上のフロンティア幅優先探索（外部メモリ BFS）
+//
+// 目標盤面から幅優先に層を広げ、層ごとの状態数と最も遠い状態を求める。
+// - スライディングパズルの状態グラフは二部グラフ（1 手ごとに空白のセルの市松模様の色が変わる）なので、
+//   層 d+1 = (層 d の隣接状態) − 層 d−1。保持するのは直前の 2 層だけで、それより古い層は消す
+// - 層は空白の位置ごとのバケットファイルに分ける（隣接状態は空白の移動先のバケットに入る）
+// - バケットファイルは昇順の盤面を差分の LEB128 で詰めたもの（15パズルの後半の層では 1 状態 2 バイト前後）
+// - 重複の除去はメモリ上のハッシュではなく、ソート済みのランのマージで行う
+//     1. 層 d を読みながら隣接状態をバケットごとのバッファに積み、メモリの上限に達したら
+//        ソート・重複除去してランファイルに書く
+//     2. バケットごとにランを k-way マージし、重複と層 d−1 の同じバケットにある状態を除いて層 d+1 のファイルに書く
+//   読み書きはすべて先頭から順に流すだけ
+// - 中断しても再開できる。ファイルは一時ファイルに書いてから rename し、
+//   ランが揃った印 (RUNS_DONE)・層が完成した印 (DONE) を置くので、再開時は完成していない所からやり直す
+//
+// ディレクトリ構成
+//   <dir>/counts.csv             : 完成した層の状態数 (depth,count)
+//   <dir>/layer_<d>/b<空白>.fbs   : 層 d のバケットファイル
+//   <dir>/layer_<d>/runs/        : 作成中の中間ラン
+//   <dir>/layer_<d>/RUNS_DONE    : 層 d のランがすべて書けた印（中身はランの数）
+//   <dir>/layer_<d>/DONE         : 層 d が完成した印（中身は状態数）
+
+namespace bfs15 {
+
+namespace fs = std::filesystem;
+
+constexpr char FBS_MAGIC[8] = {'F', 'B', 'S', '1', '\0', '\0', '\0', '\0'};
+constexpr std::size_t FBS_HEADER = 16;        // magic 8 バイト + 状態数 8 バイト
+constexpr std::size_t IO_BUFFER = 1 << 20;    // 読み書きのバッファ
+
+// 昇順の uint64 を差分の LEB128 で書く（close で先頭のヘッダに個数を書き込む）
+class DeltaWriter {
+public:
+    explicit DeltaWriter(const std::string& path) : path_(path) {
+        fp_ = std::fopen(path.c_str(), "wb");
+        if (!fp_) throw std::runtime_error("Failed to create " + path);
+        buf_.reserve(IO_BUFFER + 16);
+        buf_.resize(FBS_HEADER); // ヘッダは close で書き直す
+    }
+    ~DeltaWriter() {
+        if (fp_) std::fclose(fp_);
+    }
+    DeltaWriter(const DeltaWriter&) = delete;
+    DeltaWriter& operator=(const DeltaWriter&) = delete;
+
+    // v は直前に書いた値より大きいこと
+    void push(uint64_t v) {
+        uint64_t d = v - prev_;
+        prev_ = v;
+        while (d >= 0x80) {
+            buf_.push_back(static_cast<uint8_t>(d | 0x80));
+            d >>= 7;
+        }
+        buf_.push_back(static_cast<uint8_t>(d));
+        ++count_;
+        if (buf_.size() >= IO_BUFFER) flush();
+    }
+
+    uint64_t count() const noexcept { return count_; }
+
+    void close() {
+        flush();
+        uint8_t hdr[FBS_HEADER];
+        std::memcpy(hdr, FBS_MAGIC, 8);
+        std::memcpy(hdr + 8, &count_, 8);
+        if (std::fseek(fp_, 0, SEEK_SET) != 0 || std::fwrite(hdr, 1, FBS_HEADER, fp_) != FBS_HEADER
+            || std::fflush(fp_) != 0) {
+            fail();
+        }
+        std::fclose(fp_);
+        fp_ = nullptr;
+    }
+
+private:
+    std::string path_;
+    std::FILE* fp_ = nullptr;
+    std::vector<uint8_t> buf_;
+    uint64_t prev_ = 0;
+    uint64_t count_ = 0;
+
+    void flush() {
+        if (!buf_.empty() && std::fwrite(buf_.data(), 1, buf_.size(), fp_) != buf_.size()) fail();
+        buf_.clear();
+    }
+    [[noreturn]] void fail() {
+        std::fclose(fp_);
+        fp_ = nullptr;
+        throw std::runtime_error("Failed to write " + path_);
+    }
+};
+
+// DeltaWriter で書いたファイルを先頭から読む（ファイルが無ければ空として扱う）
+class DeltaReader {
+public:
+    explicit DeltaReader(const std::string& path) : path_(path) {
+        fp_ = std::fopen(path.c_str(), "rb");
+        if (!fp_) return;
+        uint8_t hdr[FBS_HEADER];
+        if (std::fread(hdr, 1, FBS_HEADER, fp_) != FBS_HEADER || std::memcmp(hdr, FBS_MAGIC, 8) != 0) {
+            std::fclose(fp_);
+            fp_ = nullptr;
+            throw std::runtime_error("Broken bucket file " + path);
+        }
+        std::memcpy(&remaining_, hdr + 8, 8);
+        count_ = remaining_;
+        buf_.resize(IO_BUFFER);
+    }
+    ~DeltaReader() {
+        if (fp_) std::fclose(fp_);
+    }
+    DeltaReader(const DeltaReader&) = delete;
+    DeltaReader& operator=(const DeltaReader&) = delete;
+
+    uint64_t count() const noexcept { return count_; }
+
+    // 次の値を v に入れる（終わりなら false）
+    bool next(uint64_t& v) {
+        if (remaining_ == 0) return false;
+        uint64_t d = 0;
+        for (int shift = 0;; shift += 7) {
+            const uint8_t b = byte();
+            d |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+        }
+        prev_ += d;
+        v = prev_;
+        --remaining_;
+        return true;
+    }
+
+private:
+    std::string path_;
+    std::FILE* fp_ = nullptr;
+    std::vector<uint8_t> buf_;
+    std::size_t pos_ = 0, len_ = 0;
+    uint64_t prev_ = 0;
+    uint64_t remaining_ = 0;
+    uint64_t count_ = 0;
+
+    uint8_t byte() {
+        if (pos_ == len_) {
+            len_ = std::fread(buf_.data(), 1, buf_.size(), fp_);
+            pos_ = 0;
+            if (len_ == 0) throw std::runtime_error("Truncated bucket file " + path_);
+        }
+        return buf_[pos_++];
+    }
+};
+
+// 書き終えたファイルを一時ファイルから本来の名前に置き換える
+inline void commit_file(const std::string& tmp, const std::string& path) {
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) throw std::runtime_error("Failed to rename " + tmp);
+}
+
+inline void write_text_file(const std::string& path, const std::string& text) {
+    const std::string tmp = path + ".tmp." + std::to_string(::getpid());
+    {
+        std::ofstream ofs(tmp, std::ios::trunc);
+        if (!(ofs << text) || !ofs.flush()) throw std::runtime_error("Failed to write " + tmp);
+    }
+    commit_file(tmp, path);
+}
+
+// Rows×Cols のパズルのフロンティア幅優先探索（盤面が uint64_t に収まる 16 セル以下）
+template <int Rows, int Cols>
+class FrontierBfs {
+public:
+    using Puzzle = sliding::SlidingPuzzle<Rows, Cols>;
+    static constexpr int CELLS = Puzzle::CELLS;
+    static_assert(std::is_same_v<typename Puzzle::Storage, uint64_t>, "FrontierBfs needs boards packed in uint64_t");
+
+    // dir に途中まで進んだ探索があれば続きから、無ければ目標盤面の層 0 から始める
+    // mem_mb は隣接状態を積むバッファの上限（これを超えるたびにランを書き出す）
+    FrontierBfs(const std::string& dir, std::size_t mem_mb) : dir_(dir) {
+        buffer_limit_ = std::max<std::size_t>(1, (mem_mb << 20) / sizeof(uint64_t));
+        fs::create_directories(dir_);
+        load_counts();
+        if (counts_.empty()) { // 層 0 = 目標盤面だけ
+            const Puzzle g = Puzzle::goal();
+            fs::remove_all(layer_dir(0));
+            fs::create_directories(layer_dir(0));
+            write_bucket(0, g.zero_pos, std::vector<uint64_t>{g.packed});
+            finish_layer(0, 1);
+        }
+    }
+
+    // 完成した最後の層
+    int depth() const noexcept { return static_cast<int>(counts_.size()) - 1; }
+    const std::vector<uint64_t>& counts() const noexcept { return counts_; }
+    // 最後の層が空なら探索は終わっている
+    bool finished() const noexcept { return counts_.back() == 0; }
+
+    // 1 層進めて、新しい層の状態数を返す
+    uint64_t step() {
+        const int d = depth() + 1;
+        if (!fs::exists(layer_dir(d) + "/RUNS_DONE")) {
+            fs::remove_all(layer_dir(d)); // 途中で止まったランは作り直す
+            fs::create_directories(layer_dir(d) + "/runs");
+            const int num_runs = generate_runs(d);
+            write_text_file(layer_dir(d) + "/RUNS_DONE", std::to_string(num_runs) + "\n");
+        }
+        int num_runs = 0;
+        std::ifstream(layer_dir(d) + "/RUNS_DONE") >> num_runs;
+        uint64_t total = 0;
+        for (int b = 0; b < CELLS; ++b) total += merge_bucket(d, b, num_runs);
+        finish_layer(d, total);
+        return total;
+    }
+
+    // 層 d の状態を順に f(盤面) に渡す（層 d がまだ残っていること）
+    template <class F>
+    void for_each_state(int d, F&& f) const {
+        for (int b = 0; b < CELLS; ++b) {
+            DeltaReader in(bucket_path(d, b));
+            uint64_t v;
+            while (in.next(v)) {
+                Puzzle p;
+                p.packed = v;
+                p.zero_pos = static_cast<uint8_t>(b);
+                f(p);
+            }
+        }
+    }
+
+private:
+    std::string dir_;
+    std::size_t buffer_limit_; // バッファに積む状態数の上限
+    std::vector<uint64_t> counts_;
+
+    std::string layer_dir(int d) const { return dir_ + "/layer_" + std::to_string(d); }
+    std::string bucket_path(int d, int b) const { return layer_dir(d) + "/b" + std::to_string(b) + ".fbs"; }
+    std::string run_path(int d, int b, int k) const {
+        return layer_dir(d) + "/runs/b" + std::to_string(b) + "_" + std::to_string(k) + ".fbs";
+    }
+
+    // counts.csv と、その後に完成した層（DONE があるのに counts.csv に無いもの）から状態数を読む
+    void load_counts() {
+        counts_.clear();
+        std::ifstream ifs(dir_ + "/counts.csv");
+        std::string line;
+        while (std::getline(ifs, line)) {
+            const auto comma = line.find(',');
+            if (comma == std::string::npos || line.compare(0, comma, "depth") == 0) continue;
+            counts_.push_back(std::stoull(line.substr(comma + 1)));
+        }
+        for (;;) {
+            std::ifstream done(layer_dir(static_cast<int>(counts_.size())) + "/DONE");
+            uint64_t n;
+            if (!(done >> n)) break;
+            counts_.push_back(n);
+            write_counts();
+        }
+    }
+
+    void write_counts() const {
+        std::string text = "depth,count\n";
+        for (std::size_t d = 0; d < counts_.size(); ++d) {
+            text += std::to_string(d) + "," + std::to_string(counts_[d]) + "\n";
+        }
+        write_text_file(dir_ + "/counts.csv", text);
+    }
+
+    // 層 d の完成: 印を置き、状態数を記録し、もう使わない層 d−2 とランを消す
+    void finish_layer(int d, uint64_t total) {
+        write_text_file(layer_dir(d) + "/DONE", std::to_string(total) + "\n");
+        counts_.push_back(total);
+        write_counts();
+        fs::remove_all(layer_dir(d) + "/runs");
+        if (d >= 2) fs::remove_all(layer_dir(d - 2));
+    }
+
+    // 昇順・重複なしの状態をバケットファイルに書く
+    void write_bucket(int d, int b, const std::vector<uint64_t>& sorted) const {
+        const std::string path = bucket_path(d, b);
+        const std::string tmp = path + ".tmp";
+        DeltaWriter out(tmp);
+        for (uint64_t v : sorted) out.push(v);
+        out.close();
+        commit_file(tmp, path);
+    }
+
+    // 層 d−1 の隣接状態をバケットごとのランファイルに書き、ランの数を返す
+    int generate_runs(int d) {
+        std::array<std::vector<uint64_t>, CELLS> buf;
+        std::size_t buffered = 0;
+        int run_id = 0;
+
+        auto flush = [&] {
+            for (int b = 0; b < CELLS; ++b) {
+                auto& v = buf[b];
+                if (v.empty()) continue;
+                std::sort(v.begin(), v.end());
+                v.erase(std::unique(v.begin(), v.end()), v.end());
+                const std::string path = run_path(d, b, run_id);
+                const std::string tmp = path + ".tmp";
+                DeltaWriter out(tmp);
+                for (uint64_t x : v) out.push(x);
+                out.close();
+                commit_file(tmp, path);
+                v.clear();
+            }
+            buffered = 0;
+            ++run_id;
+        };
+
+        // 親を BLOCK 個ずつ読み、sliding::expand_batch でまとめて展開する
+        constexpr std::size_t BLOCK = 4096;
+        std::vector<uint64_t> parents(BLOCK);
+        std::vector<uint8_t> zeros(BLOCK);
+        sliding::SuccessorBatch<Puzzle> children;
+        for (int b = 0; b < CELLS; ++b) {
+            DeltaReader in(bucket_path(d - 1, b));
+            std::fill(zeros.begin(), zeros.end(), static_cast<uint8_t>(b));
+            for (;;) {
+                std::size_t n = 0;
+                while (n < BLOCK && in.next(parents[n])) ++n;
+                if (n == 0) break;
+                children.clear();
+                sliding::expand_batch<Puzzle>(parents.data(), zeros.data(), n, children);
+                for (std::size_t i = 0; i < children.size(); ++i) buf[children.zero[i]].push_back(children.packed[i]);
+                buffered += children.size();
+                if (buffered >= buffer_limit_) flush();
+            }
+        }
+        if (buffered > 0) flush();
+        return run_id;
+    }
+
+    // バケット b のランをマージし、層 d−2 にある状態を除いて層 d のバケットファイルにする
+    uint64_t merge_bucket(int d, int b, int num_runs) {
+        const std::string path = bucket_path(d, b);
+        if (fs::exists(path)) return DeltaReader(path).count(); // 再開時: 既にできている
+
+        std::vector<std::unique_ptr<DeltaReader>> runs;
+        for (int k = 0; k < num_runs; ++k) {
+            runs.push_back(std::make_unique<DeltaReader>(run_path(d, b, k))); // 空のバケットはファイルが無い
+        }
+
+        using Head = std::pair<uint64_t, std::size_t>; // (値, ラン番号)
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            uint64_t v;
+            if (runs[i]->next(v)) heap.emplace(v, i);
+        }
+
+        const bool has_prev = d >= 2;
+        std::unique_ptr<DeltaReader> prev;
+        if (has_prev) prev = std::make_unique<DeltaReader>(bucket_path(d - 2, b));
+        uint64_t pv = 0;
+        bool prev_live = has_prev && prev->next(pv);
+
+        const std::string tmp = path + ".tmp";
+        DeltaWriter out(tmp);
+        bool any = false;
+        uint64_t last = 0;
+        while (!heap.empty()) {
+            const auto [v, i] = heap.top();
+            heap.pop();
+            uint64_t nv;
+            if (runs[i]->next(nv)) heap.emplace(nv, i);
+            if (any && v == last) continue; // ラン間の重複
+            any = true;
+            last = v;
+            while (prev_live && pv < v) prev_live = prev->next(pv);
+            if (prev_live && pv == v) continue; // 2 つ前の層にある（親の層へ戻る手）
+            out.push(v);
+        }
+        out.close();
+        commit_file(tmp, path);
+        return out.count();
+    }
+};
+
+} // namespace bfs15
@@ -0,0 +1,205 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <optional>
+#include <chrono>
+#include <limits>
+#include <cstdlib>
+#include "solver15.hpp"
+
+// 双方向ヒューリスティック探索 MM (Holte, Felner, Sharon, Sturtevant 2016)
+//
+// スタートからの前向き探索と、ゴールからの後ろ向き探索を交互に進め、途中で出会った経路のうち最短のものを返す。
+// - 優先度は pr(n) = max(f(n), 2g(n))。どちらの向きも自分の側の半分 (最適解の長さの半分) を超えて深くは進まない
+// - 同じ pr の中では g が大きいものから（TieBreak::HighG。出会う経路が早く見つかり U が早く縮む）
+// - 生成した子がもう一方の表にあれば、その経路の長さで上界 U を更新する
+// - U <= max(C, fminF, fminB, gminF + gminB + 1) になったら終了（C は両側の pr の最小値）。
+//   右辺はどれもまだ見つかっていない解の長さの下界なので、その時点の U が最適
+//   （fmin / gmin は古いエントリも含めて数えるので、真の値以下の安全な下界になる）
+//   さらに解の長さの偶奇は空白の位置で決まるので、偶奇の合わない下界は 1 つ上げる
+//
+// 前向きの評価器は A_star_path と同じくゴールまでの距離を、後ろ向きの評価器はスタートまでの距離を見積もる。
+// 後ろ向きを省略したときはスタートを目標にしたマンハッタン距離 (sliding::ManhattanHeuristic) を使う。
+
+namespace solver15 {
+
+namespace detail {
+
+// 値ごとの個数を数えて最小値を返す（値の範囲は [0, N)）
+template <int N>
+struct MinCounter {
+    std::array<std::size_t, N> count{};
+    int min = N;
+
+    void add(int v) noexcept {
+        ++count[v];
+        if (v < min) min = v;
+    }
+    void remove(int v) noexcept {
+        if (--count[v] == 0 && v == min) {
+            while (min < N && count[min] == 0) ++min;
+        }
+    }
+};
+
+} // namespace detail
+
+template <class HF, class HB, class P>
+inline SearchResult
+bidirectional_path(const P& start,
+                   const P& goal,
+                   HF heur_f,
+                   HB heur_b) {
+    static_assert(sliding::is_incremental_heuristic_v<HF, P>, "HF must provide reset / update / undo");
+    static_assert(sliding::is_incremental_heuristic_v<HB, P>, "HB must provide reset / update / undo");
+    using Puzzle = P;
+    using Move = sliding::Move;
+    using Key = typename P::Storage;
+    using Table = sliding::FlatStateTable<Key>;
+    constexpr int MAX_DEPTH = P::Geometry::MAX_DEPTH;
+    constexpr int PR_MAX = 2 * MAX_DEPTH; // g <= MAX_DEPTH, h <= MAX_DEPTH
+    static_assert(MAX_DEPTH <= 255, "g and h are stored as uint8_t in FlatStateTable");
+    if (!sliding::is_solvable(start, goal)) return unsolvable_result();
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto elapsed = [&] {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    SearchResult out;
+    if (start.packed == goal.packed) {
+        out.path = std::vector<Move>{};
+        out.elapsed_ms = elapsed();
+        return out;
+    }
+
+    // 片側の探索の状態（0: 前向き, 1: 後ろ向き）
+    struct Side {
+        BucketPriorityQueue<Puzzle, TieBreak::HighG, true> open{0, PR_MAX, 0, MAX_DEPTH}; // 第一キー pr, 第二キー g
+        Table table{1 << 16};
+        detail::MinCounter<PR_MAX + 1> fmin; // オープンリストの f の最小値
+        detail::MinCounter<MAX_DEPTH + 1> gmin; // オープンリストの g の最小値
+
+        void push(const Puzzle& s, int g, int h) {
+            open.push(s, std::max(g + h, 2 * g), g);
+            fmin.add(g + h);
+            gmin.add(g);
+        }
+    };
+    std::array<Side, 2> side;
+
+    // 1 手ごとに空白のセルの市松模様の色が変わるので、解の長さの偶奇は空白の位置だけで決まる
+    const int parity = (std::abs(P::row(start.zero_pos) - P::row(goal.zero_pos))
+                      + std::abs(P::col(start.zero_pos) - P::col(goal.zero_pos))) & 1;
+
+    int best = std::numeric_limits<int>::max(); // 上界 U（見つかった最短の経路長）
+    Key meet{};                                 // その経路で両側が出会った盤面
+
+    auto init = [&](Side& sd, const Puzzle& root, int h) {
+        auto& slot = *sd.table.insert(root.packed).first;
+        slot.g = 0;
+        slot.h = static_cast<uint8_t>(h);
+        sd.push(root, 0, h);
+    };
+    init(side[0], start, heur_f.reset(start));
+    init(side[1], goal, heur_b.reset(goal));
+
+    // 1 ノードを展開する（dir: 0 前向き, 1 後ろ向き）
+    auto expand = [&](int dir, auto& heur) {
+        Side& sd = side[dir];
+        Side& other = side[1 - dir];
+        Puzzle s = sd.open.top();
+        const int g_cur = sd.open.top_h();
+        sd.open.pop();
+
+        auto* slot = sd.table.find(s.packed);
+        sd.fmin.remove(g_cur + slot->h);
+        sd.gmin.remove(g_cur);
+        if (g_cur > slot->g || slot->closed()) return; // 古いエントリ・展開済み
+        slot->set_closed();
+        if (g_cur >= MAX_DEPTH) return;
+
+        const int h_parent = heur.reset(s); // 差分評価器を親の盤面に合わせる
+        const auto& succ = P::Geometry::SUCCESSORS[s.zero_pos];
+        for (int k = 0; k < succ.count; ++k) {
+            const Move m = succ.move[k];
+            const int old_zero = s.zero_pos;
+            const int new_zero = succ.to[k];
+            const uint8_t moved_tile = s.slide_blank(new_zero);
+            const int h_child = heur.update(h_parent, moved_tile, new_zero, old_zero);
+            const int g_child = g_cur + 1;
+
+            if (g_child + h_child < best) { // U を縮められない子は持たない
+                auto [cs, inserted] = sd.table.insert(s.packed);
+                if (inserted || g_child < cs->g) {
+                    cs->assign(g_child, h_child, m, old_zero);
+                    ++out.generated;
+                    sd.push(s, g_child, h_child);
+
+                    // もう一方の探索がこの盤面に到達していれば、経路がつながる
+                    if (const auto* os = other.table.find(s.packed)) {
+                        if (g_child + os->g < best) {
+                            best = g_child + os->g;
+                            meet = s.packed;
+                        }
+                    }
+                }
+            }
+
+            heur.undo(moved_tile, new_zero, old_zero);
+            s.unslide_blank(moved_tile, old_zero);
+        }
+    };
+
+    while (!side[0].open.empty() && !side[1].open.empty()) {
+        const int pr_f = side[0].open.top_f(), pr_b = side[1].open.top_f();
+        int lower = std::max({std::min(pr_f, pr_b), side[0].fmin.min, side[1].fmin.min,
+                              side[0].gmin.min + side[1].gmin.min + 1});
+        lower += (lower - parity) & 1; // 解の長さと偶奇が違う下界は 1 つ上げられる
+        if (best <= lower) break; // これ以上短い経路はない
+
+        // pr の小さい側を展開する（同じならオープンリストの小さい側）
+        const bool forward = pr_f < pr_b || (pr_f == pr_b && side[0].open.size() <= side[1].open.size());
+        if (forward) expand(0, heur_f);
+        else expand(1, heur_b);
+    }
+
+    out.stored = side[0].table.size() + side[1].table.size();
+    if (best != std::numeric_limits<int>::max()) {
+        // 出会った盤面から、前向きの表でスタートへ、後ろ向きの表でゴールへたどる
+        std::vector<Move> path;
+        Puzzle x;
+        x.packed = meet;
+        for (int i = 0; i < P::CELLS; ++i) {
+            if (x.get(i) == 0) x.zero_pos = static_cast<uint8_t>(i);
+        }
+        const Puzzle mid = x;
+        while (!(x.packed == start.packed)) {
+            const auto* slot = side[0].table.find(x.packed);
+            path.push_back(*slot->move());
+            x.undo_move_inplace(x.get(slot->prev_zero), slot->prev_zero);
+        }
+        std::reverse(path.begin(), path.end());
+        x = mid;
+        while (!(x.packed == goal.packed)) {
+            const auto* slot = side[1].table.find(x.packed);
+            path.push_back(inverse_move(*slot->move())); // 後ろ向きの手を逆にたどる
+            x.undo_move_inplace(x.get(slot->prev_zero), slot->prev_zero);
+        }
+        out.path = std::move(path);
+    }
+    out.elapsed_ms = elapsed();
+    return out;
+}
+
+// 後ろ向きの評価器を省略した版（スタートを目標にしたマンハッタン距離）
+template <class HF = puzzle15::ManhattanHeuristic, class P = puzzle15::Puzzle>
+inline SearchResult
+bidirectional_path(const P& start,
+                   const P& goal,
+                   HF heur_f = HF{}) {
+    return bidirectional_path(start, goal, heur_f, sliding::ManhattanHeuristic<P>(start));
+}
+
+} // namespace solver15
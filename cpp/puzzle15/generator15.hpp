@@ -1,10 +1,11 @@
 #pragma once
 #include <random>
-#include <utility>
-#include <vector>
+#include <optional>
 #include "puzzle15.hpp"
+#include "../sliding/generator.hpp"
 
 namespace puzzle15 {
+// 目標盤面からのランダムウォーク（1 手ごとの確保はしない。同じ乱数列なら以前と同じ盤面を作る）
 inline Puzzle generator(
     int n, // スライド操作の回数
     std::mt19937& rng, // メルセンヌツイスター (32bit) 乱数生成器
@@ -16,26 +17,25 @@ inline Puzzle generator(
     std::optional<Puzzle::Move> last = std::nullopt; // 直前の手
 
     for (int step = 0; step < n; ++step) {
-        // 合法手を列挙する
-        std::vector<std::pair<Puzzle, Puzzle::Move>> neigh = cur.neighbors();
-
-        // 直前手の反転を除外 (avoid_backtrack が true の場合)
-        if (avoid_backtrack && last.has_value()) {
-            const Puzzle::Move ban = cur.inverse(*last);
-            std::vector<std::pair<Puzzle, Puzzle::Move>> filtered; // 直前手の反転を除外した手
-            filtered.reserve(neigh.size());
-            for (auto& pr : neigh) {
-                if (pr.second != ban) filtered.push_back(std::move(pr));
-            }
-            if (!filtered.empty()) neigh.swap(filtered); // 全部が反転手ならそのまま
+        // 合法手を列挙する（順序は MOVES と同じ）
+        const auto& succ = Puzzle::Geometry::SUCCESSORS[cur.zero_pos];
+        int cand[4];
+        std::size_t k = 0;
+        for (int j = 0; j < succ.count; ++j) {
+            // 直前手の反転を除外 (avoid_backtrack が true の場合)
+            if (avoid_backtrack && last.has_value() && succ.move[j] == Puzzle::inverse(*last)) continue;
+            cand[k++] = j;
+        }
+        if (k == 0) { // 全部が反転手ならそのまま
+            for (int j = 0; j < succ.count; ++j) cand[k++] = j;
         }
 
         // ランダムに 1 手選ぶ
-        std::uniform_int_distribution<std::size_t> dist(0, neigh.size() - 1); // 一様分布
-        auto& pick = neigh[dist(rng)];
+        std::uniform_int_distribution<std::size_t> dist(0, k - 1); // 一様分布
+        const int pick = cand[dist(rng)];
 
-        last = pick.second;
-        cur  = pick.first;
+        last = succ.move[pick];
+        cur.slide_blank(succ.to[pick]);
     }
     return cur;
 }
@@ -55,4 +55,14 @@ inline Puzzle generate_random_puzzle(
     }
 }
 
-} // namespace puzzle15
\ No newline at end of file
+// goal から行ける盤面を一様に選ぶ（ランダムウォークと違って手数に偏りがなく、問題どうしの相関もない）
+// 続けて多数作るときは乱数生成器を使い回す sliding::random_solvable を使う
+inline Puzzle generate_uniform_puzzle(
+    std::optional<std::uint32_t> seed,
+    const Puzzle& goal = Puzzle::goal()
+) {
+    std::mt19937 rng(seed.has_value() ? *seed : std::random_device{}());
+    return sliding::random_solvable(rng, goal);
+}
+
+} // namespace puzzle15
@@ -1,4 +1,12 @@
 #pragma once
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <unordered_map>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 #include "puzzle15.hpp"
 
 namespace puzzle15 {
@@ -14,11 +22,15 @@ inline int misplaced_heuristic(const Puzzle& p) {
 }
 
 inline int MDIST[16][16];
+inline uint8_t MD_GOAL_ROW[16]; // タイル → 目標の行（manhattan_batch 用。空白の値は使わない）
+inline uint8_t MD_GOAL_COL[16]; // タイル → 目標の列
 
 inline void init_manhattan_table() {
     for (int tile = 1; tile < 16; ++tile) {
         int tr = tile / 4; // タイルの目標行
         int tc = tile % 4; // タイルの目標列
+        MD_GOAL_ROW[tile] = static_cast<uint8_t>(tr);
+        MD_GOAL_COL[tile] = static_cast<uint8_t>(tc);
         for (int pos = 0; pos < 16; ++pos) {
             int r = pos / 4; // 現在の行
             int c = pos % 4; // 現在の列
@@ -27,6 +39,22 @@ inline void init_manhattan_table() {
     }
 }
 
+// 任意の目標盤面に対するマンハッタン距離テーブル
+inline void init_manhattan_table(const Puzzle& goal) {
+    for (int tile = 0; tile < 16; ++tile) {
+        for (int pos = 0; pos < 16; ++pos) MDIST[tile][pos] = 0;
+    }
+    for (int g = 0; g < 16; ++g) {
+        const int tile = goal.get(g);
+        if (tile == 0) continue;
+        MD_GOAL_ROW[tile] = static_cast<uint8_t>(Puzzle::row(g));
+        MD_GOAL_COL[tile] = static_cast<uint8_t>(Puzzle::col(g));
+        for (int pos = 0; pos < 16; ++pos) {
+            MDIST[tile][pos] = std::abs(Puzzle::row(g) - Puzzle::row(pos)) + std::abs(Puzzle::col(g) - Puzzle::col(pos));
+        }
+    }
+}
+
 inline int manhattan_heuristic(const Puzzle& p) {
     int d = 0; // マンハッタン距離
     for (int i = 0; i < 16; ++i) {
@@ -54,8 +82,449 @@ inline int manhattan_delta_for_move(int h, uint8_t t, int oldPos, int newPos) {
     return h - MDIST[t][oldPos] + MDIST[t][newPos];
 }
 
+// n 個の盤面のマンハッタン距離をまとめて求める（init_manhattan_table の後に使う）
+// AVX2 が使えるとき（-mavx2 / -march=native）は 4 盤面ずつ
+//   1. 4bit のタイルを 1 バイトずつに広げる（下位・上位のニブルを分けて unpack）
+//   2. pshufb でタイル → 目標の行・列を表引きする（16 要素の表がちょうど 1 レジスタに載る）
+//   3. 空白のバイトは今のセルの行・列に置き換えて距離 0 にする
+//   4. psadbw で今のセルの行・列との差の絶対値を 8 バイトずつ足す
+// 端数と AVX2 がないときは MDIST を引く
+inline void manhattan_batch(const uint64_t* packed, std::size_t n, uint8_t* out) {
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m128i goal_row = _mm_loadu_si128(reinterpret_cast<const __m128i*>(MD_GOAL_ROW));
+    const __m128i goal_col = _mm_loadu_si128(reinterpret_cast<const __m128i*>(MD_GOAL_COL));
+    const __m256i row_tab = _mm256_broadcastsi128_si256(goal_row);
+    const __m256i col_tab = _mm256_broadcastsi128_si256(goal_col);
+    const __m256i cell_row = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                              0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+    const __m256i cell_col = _mm256_setr_epi8(0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3,
+                                              0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3);
+    const __m256i low4 = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+
+    // 1 レーンに 1 盤面（16 セル = 16 バイト）を置いた 2 盤面分の距離（64bit 要素 0 と 2 に入る）
+    auto distance2 = [&](__m256i tiles) {
+        const __m256i blank = _mm256_cmpeq_epi8(tiles, zero);
+        const __m256i r = _mm256_blendv_epi8(_mm256_shuffle_epi8(row_tab, tiles), cell_row, blank);
+        const __m256i c = _mm256_blendv_epi8(_mm256_shuffle_epi8(col_tab, tiles), cell_col, blank);
+        const __m256i d = _mm256_add_epi64(_mm256_sad_epu8(r, cell_row), _mm256_sad_epu8(c, cell_col));
+        return _mm256_add_epi64(d, _mm256_srli_si256(d, 8));
+    };
+
+    for (; i + 4 <= n; i += 4) {
+        // レーン 0 に盤面 i, i+1、レーン 1 に盤面 i+2, i+3
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(packed + i));
+        const __m256i lo = _mm256_and_si256(x, low4);                        // 偶数セル
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi64(x, 4), low4);  // 奇数セル
+        const __m256i d02 = distance2(_mm256_unpacklo_epi8(lo, hi)); // 盤面 i, i+2
+        const __m256i d13 = distance2(_mm256_unpackhi_epi8(lo, hi)); // 盤面 i+1, i+3
+        out[i]     = static_cast<uint8_t>(_mm256_extract_epi64(d02, 0));
+        out[i + 1] = static_cast<uint8_t>(_mm256_extract_epi64(d13, 0));
+        out[i + 2] = static_cast<uint8_t>(_mm256_extract_epi64(d02, 2));
+        out[i + 3] = static_cast<uint8_t>(_mm256_extract_epi64(d13, 2));
+    }
+#endif
+    for (; i < n; ++i) {
+        int d = 0;
+        for (int pos = 0; pos < 16; ++pos) {
+            const uint8_t t = static_cast<uint8_t>((packed[i] >> (4 * pos)) & 0xF);
+            d += MDIST[t][pos]; // 空白の行は 0
+        }
+        out[i] = static_cast<uint8_t>(d);
+    }
+}
+
 inline int const_heuristic(const Puzzle& p) {
     return 0;
 }
 
-} // namespace puzzle15
\ No newline at end of file
+// 探索器に渡す差分評価器（マンハッタン距離）
+// reset: 盤面から全計算, update: タイル t が oldPos → newPos へ動いたときの h, undo: 内部状態を戻す
+struct ManhattanHeuristic {
+    inline int reset(const Puzzle& s) const noexcept { return manhattan_heuristic_fast(s); }
+    inline int update(int h, uint8_t t, int oldPos, int newPos) const noexcept {
+        return manhattan_delta_for_move(h, t, oldPos, newPos);
+    }
+    inline void undo(uint8_t, int, int) const noexcept {}
+    inline void evaluate_batch(const uint64_t* packed, const uint8_t*, std::size_t n, uint8_t* h) const noexcept {
+        manhattan_batch(packed, n, h);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// 線形衝突 (Linear Conflict) + コーナータイル + 最終手
+//
+// 1 行（1 列）の 4 ニブル = 16bit をキーにした表で、その行（列）の衝突による追加手数を引く。
+// 空白を横に動かしても行内のタイルの並び順は変わらないので、横移動で変わるのは 2 本の列だけ、
+// 縦移動で変わるのは 2 本の行だけ。行・列の衝突は、変わる 2 本の新旧で表引き 4 回の差分更新になる。
+// コーナー/最終手の項は評価器が値を持っておき、それが変わりうる手のときだけ引き直す。
+//
+// 表の値: 下位 4bit = 追加手数 (2 × 取り除くべきタイル数), 上位 4bit = 衝突に関わるセル (行/列内の位置)
+inline uint8_t LC_ROW[4][1 << 16];
+inline uint8_t LC_COL[4][1 << 16];
+inline uint8_t LC_GOAL_TILE[16];  // セル → 目標盤面でそこにあるタイル
+inline uint8_t LC_GOAL_CELL[16];  // タイル → 目標位置
+inline uint64_t LC_GOAL_PACKED = 0;
+
+// コーナー: {角, 隣接セル, 隣接セル}
+inline constexpr int LC_CORNER[4][3] = {{0, 1, 4}, {3, 2, 7}, {12, 13, 8}, {15, 14, 11}};
+inline uint32_t LC_CORNER_CELLS = 0; // 判定に使うコーナー (目標の空白を含まないもの) のセル
+// 最終手: 目標の空白セルに隣接するセルと、そこに入るタイル
+inline int LC_LAST_COUNT = 0;
+inline uint8_t LC_LAST_CELL[4];
+inline uint8_t LC_LAST_TILE[4];
+inline uint8_t LC_LAST_INDEX[16]; // タイル → LC_LAST_TILE の添字 (最終手に関係しないタイルは 0xFF)
+
+// 目標位置 key[i] (このラインに属さないタイルは -1) の並びから衝突を求める
+inline uint8_t line_conflict_entry(const int* goal_idx) {
+    // 残すタイルが目標順に並ぶ最大集合 (LIS) を 4 要素の全部分集合から求める
+    int best = 0, members = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (goal_idx[i] >= 0) ++members;
+    }
+    for (int mask = 0; mask < 16; ++mask) {
+        int last = -1, cnt = 0;
+        bool ok = true;
+        for (int i = 0; i < 4 && ok; ++i) {
+            if (!(mask & (1 << i))) continue;
+            if (goal_idx[i] < 0 || goal_idx[i] <= last) ok = false;
+            last = goal_idx[i];
+            ++cnt;
+        }
+        if (ok && cnt > best) best = cnt;
+    }
+    int involved = 0;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = i + 1; j < 4; ++j) {
+            if (goal_idx[i] >= 0 && goal_idx[j] >= 0 && goal_idx[i] > goal_idx[j]) involved |= (1 << i) | (1 << j);
+        }
+    }
+    return static_cast<uint8_t>(2 * (members - best) | (involved << 4));
+}
+
+inline void init_linear_conflict_table(const Puzzle& goal) {
+    LC_GOAL_PACKED = goal.packed;
+    for (int c = 0; c < 16; ++c) {
+        LC_GOAL_TILE[c] = goal.get(c);
+        LC_GOAL_CELL[goal.get(c)] = static_cast<uint8_t>(c);
+    }
+    const int z = LC_GOAL_CELL[0];
+    LC_CORNER_CELLS = 0;
+    for (const auto& cn : LC_CORNER) {
+        if (cn[0] == z || cn[1] == z || cn[2] == z) continue;
+        LC_CORNER_CELLS |= (1u << cn[0]) | (1u << cn[1]) | (1u << cn[2]);
+    }
+    LC_LAST_COUNT = 0;
+    for (int t = 0; t < 16; ++t) LC_LAST_INDEX[t] = 0xFF;
+    for (int n : Puzzle::Geometry::NEIGHBOR[z]) { // 上下左右の順（盤外は -1）
+        if (n < 0) continue;
+        LC_LAST_CELL[LC_LAST_COUNT] = static_cast<uint8_t>(n);
+        LC_LAST_TILE[LC_LAST_COUNT] = LC_GOAL_TILE[n];
+        LC_LAST_INDEX[LC_GOAL_TILE[n]] = static_cast<uint8_t>(LC_LAST_COUNT);
+        ++LC_LAST_COUNT;
+    }
+    for (int line = 0; line < 4; ++line) {
+        for (int key = 0; key < (1 << 16); ++key) {
+            int row_idx[4], col_idx[4];
+            for (int i = 0; i < 4; ++i) {
+                const int t = (key >> (i * 4)) & 0xF;
+                const int g = LC_GOAL_CELL[t];
+                row_idx[i] = (t != 0 && Puzzle::row(g) == line) ? Puzzle::col(g) : -1;
+                col_idx[i] = (t != 0 && Puzzle::col(g) == line) ? Puzzle::row(g) : -1;
+            }
+            LC_ROW[line][key] = line_conflict_entry(row_idx);
+            LC_COL[line][key] = line_conflict_entry(col_idx);
+        }
+    }
+}
+
+static inline uint32_t lc_row_key(uint64_t b, int r) noexcept {
+    return static_cast<uint32_t>((b >> (r * 16)) & 0xFFFFu);
+}
+
+static inline uint32_t lc_col_key(uint64_t b, int c) noexcept {
+    const uint64_t x = b >> (c * 4);
+    return static_cast<uint32_t>((x & 0xFu) | ((x >> 12) & 0xF0u) | ((x >> 24) & 0xF00u) | ((x >> 36) & 0xF000u));
+}
+
+inline int linear_conflict_lines(uint64_t b) noexcept {
+    int d = 0;
+    for (int i = 0; i < 4; ++i) {
+        d += LC_ROW[i][lc_row_key(b, i)] & 0xF;
+        d += LC_COL[i][lc_col_key(b, i)] & 0xF;
+    }
+    return d;
+}
+
+// セル pos のタイルが行か列の衝突に関わっているか
+static inline bool lc_involved(uint64_t b, int pos) noexcept {
+    const int r = Puzzle::row(pos), c = Puzzle::col(pos);
+    return ((LC_ROW[r][lc_row_key(b, r)] >> 4) & (1 << c)) || ((LC_COL[c][lc_col_key(b, c)] >> 4) & (1 << r));
+}
+
+// 最終手の判定に使うタイル LC_LAST_TILE[k] の位置を盤面から探す
+inline void lc_last_positions(uint64_t b, uint8_t* pos) noexcept {
+    for (int p = 0; p < 16; ++p) {
+        const uint8_t k = LC_LAST_INDEX[Puzzle::nibble(b, p)];
+        if (k != 0xFF) pos[k] = static_cast<uint8_t>(p);
+    }
+}
+
+// コーナータイルと最終手による追加手数（pos[k] は LC_LAST_TILE[k] の位置）
+// 同じタイルの余分な 2 手を二重に数えないよう、使ったタイルを除外しながら足す。
+// watch には、そのセルを通る行か列の衝突が変わると結果も変わりうるセルを入れる
+inline int corner_last_move_extra(uint64_t b, const uint8_t* pos, uint32_t& watch) noexcept {
+    watch = 0;
+    if (b == LC_GOAL_PACKED) return 0;
+    const int z = LC_GOAL_CELL[0];
+    int extra = 0;
+    uint32_t used = 0; // すでに数えたセル
+
+    // コーナー: 角のタイルが違い、隣接 2 セルが正しく（かつ衝突に無関係）なら、どちらかが一度どく
+    for (const auto& cn : LC_CORNER) {
+        const int c = cn[0], a = cn[1], v = cn[2];
+        if (c == z || a == z || v == z) continue;
+        if (Puzzle::nibble(b, c) == LC_GOAL_TILE[c]) continue;
+        if (Puzzle::nibble(b, a) != LC_GOAL_TILE[a] || Puzzle::nibble(b, v) != LC_GOAL_TILE[v]) continue;
+        watch |= (1u << a) | (1u << v);
+        if ((used & ((1u << a) | (1u << v))) || lc_involved(b, a) || lc_involved(b, v)) continue;
+        used |= (1u << a) | (1u << v);
+        extra += 2;
+    }
+
+    // 最終手: 最後に動くのは目標の空白セルに隣接するタイルのどれか。
+    // どのタイルも現在位置から目標の空白セルを経由すると 2 手余分にかかるなら 2 を足す
+    const int zr = Puzzle::row(z), zc = Puzzle::col(z);
+    uint32_t last = 0;
+    bool ok = true;
+    for (int k = 0; k < LC_LAST_COUNT; ++k) {
+        const int n = LC_LAST_CELL[k], p = pos[k];
+        const int pr = Puzzle::row(p), pc = Puzzle::col(p);
+        const int via = std::abs(pr - zr) + std::abs(pc - zc) + 1;
+        const int direct = std::abs(pr - Puzzle::row(n)) + std::abs(pc - Puzzle::col(n));
+        if (via == direct) return extra; // 位置だけで決まる（衝突には依らない）
+        last |= 1u << p;
+        if ((used & (1u << p)) || lc_involved(b, p)) ok = false;
+    }
+    watch |= last;
+    return ok ? extra + 2 : extra;
+}
+
+inline int corner_last_move_extra(uint64_t b) noexcept {
+    uint8_t pos[4];
+    uint32_t watch;
+    lc_last_positions(b, pos);
+    return corner_last_move_extra(b, pos, watch);
+}
+
+inline int linear_conflict_heuristic(const Puzzle& p) {
+    return manhattan_heuristic_fast(p) + linear_conflict_lines(p.packed) + corner_last_move_extra(p.packed);
+}
+
+// 差分評価器（マンハッタン + 線形衝突 + コーナー/最終手）
+// 盤面を持っておき、動いたタイルが通る 2 本のラインだけ表を引き直す。
+// コーナー/最終手の項は、動いたタイルか空白がコーナーのセルに触れるか、最終手のタイルが動くか、
+// 変わる 2 本のラインが watch のセルを通るときだけ引き直し、undo では引き直さずに積んだ値へ戻す
+struct LinearConflictHeuristic {
+    struct Saved {
+        uint32_t watch;
+        int extra;
+    };
+
+    uint64_t board = 0;
+    int extra = 0;           // 今の盤面のコーナー/最終手の追加手数
+    uint32_t watch = 0;      // corner_last_move_extra が返したセル
+    uint8_t last_pos[4]{};   // LC_LAST_TILE[k] の位置
+    std::array<Saved, Puzzle::Geometry::MAX_DEPTH + 1> saved{}; // update ごとに積み、undo で戻す
+    int depth = 0;
+
+    inline int reset(const Puzzle& s) noexcept {
+        board = s.packed;
+        depth = 0;
+        lc_last_positions(board, last_pos);
+        extra = corner_last_move_extra(board, last_pos, watch);
+        return manhattan_heuristic_fast(s) + linear_conflict_lines(board) + extra;
+    }
+
+    inline int update(int h, uint8_t t, int oldPos, int newPos) noexcept {
+        const uint64_t before = board;
+        Puzzle::set_nibble(board, oldPos, 0);
+        Puzzle::set_nibble(board, newPos, t);
+
+        int lines = 0;
+        uint32_t line_cells = 0; // 変わる 2 本のラインのセル
+        if (Puzzle::row(oldPos) == Puzzle::row(newPos)) { // 横移動 → 2 本の列が変わる
+            const int c0 = Puzzle::col(oldPos), c1 = Puzzle::col(newPos);
+            lines = (LC_COL[c0][lc_col_key(board, c0)] & 0xF) + (LC_COL[c1][lc_col_key(board, c1)] & 0xF)
+                  - (LC_COL[c0][lc_col_key(before, c0)] & 0xF) - (LC_COL[c1][lc_col_key(before, c1)] & 0xF);
+            line_cells = (0x1111u << c0) | (0x1111u << c1);
+        } else { // 縦移動 → 2 本の行が変わる
+            const int r0 = Puzzle::row(oldPos), r1 = Puzzle::row(newPos);
+            lines = (LC_ROW[r0][lc_row_key(board, r0)] & 0xF) + (LC_ROW[r1][lc_row_key(board, r1)] & 0xF)
+                  - (LC_ROW[r0][lc_row_key(before, r0)] & 0xF) - (LC_ROW[r1][lc_row_key(before, r1)] & 0xF);
+            line_cells = (0xFu << (Puzzle::COLS * r0)) | (0xFu << (Puzzle::COLS * r1));
+        }
+
+        const int prev = extra;
+        saved[depth++] = Saved{watch, extra};
+        const uint8_t k = LC_LAST_INDEX[t];
+        if (k != 0xFF) last_pos[k] = static_cast<uint8_t>(newPos);
+        if (k != 0xFF || (((1u << oldPos) | (1u << newPos)) & LC_CORNER_CELLS) || (line_cells & watch)) {
+            extra = corner_last_move_extra(board, last_pos, watch);
+        }
+        return h - MDIST[t][oldPos] + MDIST[t][newPos] + lines - prev + extra;
+    }
+
+    inline void undo(uint8_t t, int oldPos, int newPos) noexcept {
+        Puzzle::set_nibble(board, newPos, 0);
+        Puzzle::set_nibble(board, oldPos, t);
+        const uint8_t k = LC_LAST_INDEX[t];
+        if (k != 0xFF) last_pos[k] = static_cast<uint8_t>(oldPos);
+        const Saved& s = saved[--depth];
+        watch = s.watch;
+        extra = s.extra;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Walking Distance (高橋謙一郎氏の WD)
+//
+// 行方向の状態は「行 r にある、目標の行が g のタイルの個数」M[r][g] (4×4) と空白の行の組。
+// 縦の 1 手で変わるのは空白の行と隣の行の 1 個だけなので、状態数は 2 万 5 千程度に収まる。
+// 目標からの BFS で各状態の最小手数と遷移表を作っておき、探索中は行・列それぞれの状態番号だけを差分更新する。
+// 列方向も同じ（目標の列で数える）。h = 行の WD + 列の WD。
+struct WalkingDistanceTable {
+    std::vector<uint8_t> dist;                  // 状態番号 → 最小手数
+    std::vector<std::array<uint16_t, 8>> next;  // [状態][空白の向き(0:上,1:下) * 4 + 動くタイルの目標ライン] → 状態 (0xFFFF: 不可)
+    std::unordered_map<uint64_t, uint16_t> index; // 符号化した状態 → 状態番号（reset 時のみ使う）
+
+    // M[r][g] を 3bit ずつ、空白の行を上位に詰める
+    static uint64_t encode(const std::array<std::array<uint8_t, 4>, 4>& m, int blank) {
+        uint64_t key = 0;
+        for (int r = 0; r < 4; ++r) {
+            for (int g = 0; g < 4; ++g) key |= static_cast<uint64_t>(m[r][g]) << (3 * (r * 4 + g));
+        }
+        return key | (static_cast<uint64_t>(blank) << 48);
+    }
+
+    static void decode(uint64_t key, std::array<std::array<uint8_t, 4>, 4>& m, int& blank) {
+        for (int r = 0; r < 4; ++r) {
+            for (int g = 0; g < 4; ++g) m[r][g] = static_cast<uint8_t>((key >> (3 * (r * 4 + g))) & 7);
+        }
+        blank = static_cast<int>((key >> 48) & 3);
+    }
+
+    // 目標の空白ラインが goal_blank のときの表を作る
+    void build(int goal_blank) {
+        dist.clear();
+        next.clear();
+        index.clear();
+
+        std::array<std::array<uint8_t, 4>, 4> m{};
+        for (int g = 0; g < 4; ++g) m[g][g] = static_cast<uint8_t>(g == goal_blank ? 3 : 4);
+
+        std::vector<uint64_t> keys;
+        keys.push_back(encode(m, goal_blank));
+        index.emplace(keys[0], 0);
+        dist.push_back(0);
+
+        for (std::size_t head = 0; head < keys.size(); ++head) {
+            int blank;
+            decode(keys[head], m, blank);
+            std::array<uint16_t, 8> nx;
+            nx.fill(0xFFFF);
+            for (int dir = 0; dir < 2; ++dir) {
+                const int nb = blank + (dir == 0 ? -1 : 1);
+                if (nb < 0 || nb > 3) continue;
+                for (int g = 0; g < 4; ++g) {
+                    if (m[nb][g] == 0) continue;
+                    // 隣の行の目標ライン g のタイルが空白の行へ移り、空白は隣の行へ
+                    --m[nb][g];
+                    ++m[blank][g];
+                    const uint64_t key = encode(m, nb);
+                    ++m[nb][g];
+                    --m[blank][g];
+
+                    auto it = index.find(key);
+                    if (it == index.end()) {
+                        it = index.emplace(key, static_cast<uint16_t>(keys.size())).first;
+                        keys.push_back(key);
+                        dist.push_back(static_cast<uint8_t>(dist[head] + 1));
+                    }
+                    nx[dir * 4 + g] = it->second;
+                }
+            }
+            next.push_back(nx);
+        }
+    }
+
+    // line_of(pos) = セルのライン, goal_line[t] = タイルの目標ライン
+    template <class LineOf>
+    uint16_t id_of(const Puzzle& s, LineOf line_of, const uint8_t* goal_line) const {
+        std::array<std::array<uint8_t, 4>, 4> m{};
+        int blank = 0;
+        for (int pos = 0; pos < 16; ++pos) {
+            const uint8_t t = s.get(pos);
+            if (t == 0) blank = line_of(pos);
+            else ++m[line_of(pos)][goal_line[t]];
+        }
+        return index.at(encode(m, blank));
+    }
+};
+
+inline WalkingDistanceTable WD_ROW;   // 縦の移動（行の状態）
+inline WalkingDistanceTable WD_COL;   // 横の移動（列の状態）
+inline uint8_t WD_GOAL_ROW[16];
+inline uint8_t WD_GOAL_COL[16];
+
+inline void init_walking_distance_table(const Puzzle& goal) {
+    for (int c = 0; c < 16; ++c) {
+        WD_GOAL_ROW[goal.get(c)] = static_cast<uint8_t>(Puzzle::row(c));
+        WD_GOAL_COL[goal.get(c)] = static_cast<uint8_t>(Puzzle::col(c));
+    }
+    WD_ROW.build(Puzzle::row(goal.zero_pos));
+    WD_COL.build(Puzzle::col(goal.zero_pos));
+}
+
+inline int walking_distance_heuristic(const Puzzle& p) {
+    const uint16_t r = WD_ROW.id_of(p, [](int pos) { return Puzzle::row(pos); }, WD_GOAL_ROW);
+    const uint16_t c = WD_COL.id_of(p, [](int pos) { return Puzzle::col(pos); }, WD_GOAL_COL);
+    return WD_ROW.dist[r] + WD_COL.dist[c];
+}
+
+// 差分評価器: 行・列の状態番号を持ち、1 手ごとに遷移表を 1 回引く
+struct WalkingDistanceHeuristic {
+    uint16_t row_id = 0;
+    uint16_t col_id = 0;
+
+    inline int reset(const Puzzle& s) {
+        row_id = WD_ROW.id_of(s, [](int pos) { return Puzzle::row(pos); }, WD_GOAL_ROW);
+        col_id = WD_COL.id_of(s, [](int pos) { return Puzzle::col(pos); }, WD_GOAL_COL);
+        return WD_ROW.dist[row_id] + WD_COL.dist[col_id];
+    }
+
+    // タイル t が from → to へ動く（空白は to → from）ときの遷移
+    static inline void step(uint16_t& row_id, uint16_t& col_id, uint8_t t, int from, int to) noexcept {
+        const int fr = Puzzle::row(from), tr = Puzzle::row(to);
+        if (fr != tr) {
+            const int dir = (fr < tr) ? 0 : 1; // 空白は to の行から from の行へ（上:0, 下:1）
+            row_id = WD_ROW.next[row_id][dir * 4 + WD_GOAL_ROW[t]];
+        } else {
+            const int dir = (Puzzle::col(from) < Puzzle::col(to)) ? 0 : 1;
+            col_id = WD_COL.next[col_id][dir * 4 + WD_GOAL_COL[t]];
+        }
+    }
+
+    inline int update(int h, uint8_t t, int oldPos, int newPos) noexcept {
+        const int before = WD_ROW.dist[row_id] + WD_COL.dist[col_id];
+        step(row_id, col_id, t, oldPos, newPos);
+        return h - before + WD_ROW.dist[row_id] + WD_COL.dist[col_id];
+    }
+
+    inline void undo(uint8_t t, int oldPos, int newPos) noexcept {
+        step(row_id, col_id, t, newPos, oldPos);
+    }
+};
+
+} // namespace puzzle15
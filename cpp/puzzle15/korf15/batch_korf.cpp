@@ -0,0 +1,159 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include "../puzzle15.hpp"
+#include "korf15.hpp"
+#include "../pdb15.hpp"
+#include "../pdb_file15.hpp"
+#include "../solver15.hpp"
+#include "../low_memory_solver15.hpp"
+#include "../../sliding/work_stealing_pool.hpp"
+
+// Korf の問題集をまとめて解くバッチドライバ
+// 問題ファイルの読み込みとヒューリスティックの初期化は 1 回だけ行い、
+// 問題をスレッドプールに配って 1 スレッド 1 ソルバーで並行に解く。
+// 結果は問題ごとに CSV か JSON（出力ファイルの拡張子で決める）に書き出す。
+//
+// ./batch <最初の問題番号> <最後の問題番号> <ida|a|pea|fa> <manhattan|linear|wd|pdb663|pdb78> <スレッド数> <出力ファイル>
+
+struct InstanceResult {
+    int problem = 0;        // 問題番号（1-based）
+    bool solved = false;
+    bool unsolvable = false; // 偶奇が違うので探索しなかった
+    std::size_t length = 0;
+    std::size_t generated = 0;
+    long long elapsed_ms = 0;
+    unsigned thread = 0;    // 解いたワーカー
+};
+
+static bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static void write_csv(std::ostream& os, const std::vector<InstanceResult>& results) {
+    os << "problem,solved,unsolvable,length,generated,elapsed_ms,thread\n";
+    for (const auto& r : results) {
+        os << r.problem << ',' << (r.solved ? 1 : 0) << ',' << (r.unsolvable ? 1 : 0) << ',' << r.length << ','
+           << r.generated << ',' << r.elapsed_ms << ',' << r.thread << '\n';
+    }
+}
+
+static void write_json(std::ostream& os, const std::vector<InstanceResult>& results,
+                       const std::string& solver, const std::string& heur, unsigned threads, long long wall_ms) {
+    os << "{\n";
+    os << "  \"solver\": \"" << solver << "\",\n";
+    os << "  \"heuristic\": \"" << heur << "\",\n";
+    os << "  \"threads\": " << threads << ",\n";
+    os << "  \"wall_ms\": " << wall_ms << ",\n";
+    os << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        os << "    {\"problem\": " << r.problem << ", \"solved\": " << (r.solved ? "true" : "false")
+           << ", \"unsolvable\": " << (r.unsolvable ? "true" : "false")
+           << ", \"length\": " << r.length << ", \"generated\": " << r.generated
+           << ", \"elapsed_ms\": " << r.elapsed_ms << ", \"thread\": " << r.thread << "}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    auto problems = korf15::load_korf_problems("15-puzzle-states.txt");
+    auto goal = problems[100];
+    const int num_problems = 100; // 101 行目は目標盤面
+
+    int first = 1, last = num_problems;
+    std::string slv = "ida";
+    std::string heur = "manhattan";
+    unsigned threads = 0; // 0 なら全コア
+    std::string out_path = "korf_results.csv";
+
+    if (argc >= 2) first = std::atoi(argv[1]);
+    if (argc >= 3) last = std::atoi(argv[2]);
+    if (argc >= 4) slv = argv[3];
+    if (argc >= 5) heur = argv[4];
+    if (argc >= 6) threads = static_cast<unsigned>(std::atoi(argv[5]));
+    if (argc >= 7) out_path = argv[6];
+
+    if (first < 1 || last > num_problems || first > last) {
+        std::cerr << "Invalid problem range. Please specify 1 <= first <= last <= " << num_problems << ".\n";
+        return 1;
+    }
+    if (slv != "ida" && slv != "a" && slv != "pea" && slv != "fa") {
+        std::cerr << "Unknown solver: " << slv << " (ida / a / pea / fa)\n";
+        return 1;
+    }
+    if (!puzzle15::find_heuristic(heur)) {
+        std::cerr << "Unknown heuristic: " << heur << " (" << puzzle15::heuristic_names() << ")\n";
+        return 1;
+    }
+    const bool json = ends_with(out_path, ".json");
+    if (!json && !ends_with(out_path, ".csv")) {
+        std::cerr << "Output file must end with .csv or .json\n";
+        return 1;
+    }
+
+    {
+        auto tb0 = std::chrono::steady_clock::now();
+        puzzle15::init_heuristic(heur, goal);
+        auto tb1 = std::chrono::steady_clock::now();
+        std::cout << "Initialized " << heur << " in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(tb1 - tb0).count() << " ms\n";
+    }
+
+    std::vector<solver15::SearchContext<>> contexts; // A* の作業領域（ワーカーごとに 1 つを使い回す）
+
+    auto solve = [&](unsigned id, const puzzle15::Puzzle& p) {
+        return puzzle15::with_heuristic(heur, [&](auto h) {
+            if (slv == "ida") return solver15::IDA_star_path(p, goal, h);
+            if (slv == "pea") return solver15::PEA_star_path(p, goal, h);
+            if (slv == "fa") return solver15::frontier_A_star_path(p, goal, h);
+            return solver15::A_star_path(contexts[id], p, goal, h);
+        });
+    };
+
+    std::vector<InstanceResult> results(last - first + 1);
+    sliding::WorkStealingPool pool(threads);
+    if (slv == "a") contexts.resize(pool.size());
+
+    auto t0 = std::chrono::steady_clock::now();
+    pool.run(results.size(), [&](unsigned id, std::size_t i) {
+        InstanceResult& r = results[i];
+        r.problem = first + static_cast<int>(i);
+        r.thread = id;
+        const auto result = solve(id, problems[r.problem - 1]);
+        r.solved = result.path.has_value();
+        r.unsolvable = result.unsolvable;
+        r.length = r.solved ? result.path->size() : 0;
+        r.generated = result.generated;
+        r.elapsed_ms = result.elapsed_ms;
+    });
+    auto t1 = std::chrono::steady_clock::now();
+    const long long wall_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+
+    std::ofstream ofs(out_path);
+    if (!ofs) {
+        std::cerr << "Failed to open " << out_path << "\n";
+        return 1;
+    }
+    if (json) write_json(ofs, results, slv, heur, pool.size(), wall_ms);
+    else write_csv(ofs, results);
+
+    // 全体の集計
+    std::size_t generated_total = 0;
+    int solved = 0;
+    for (const auto& r : results) {
+        generated_total += r.generated;
+        if (r.solved) solved++;
+    }
+    std::cout << slv << " batch Results ( problems " << first << "-" << last << ", " << pool.size() << " threads):\n";
+    std::cout << "Solved: " << solved << " / " << results.size() << "\n";
+    std::cout << "Generated nodes: " << generated_total << "\n";
+    std::cout << "Wall time: " << wall_ms << " ms\n";
+    std::cout << "Generated nodes per second: " << static_cast<double>(generated_total) / (wall_ms / 1000.0) << "\n";
+    std::cout << "Results written to " << out_path << "\n";
+    return 0;
+}
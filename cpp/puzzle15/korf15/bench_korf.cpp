@@ -0,0 +1,259 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <sys/resource.h>
+#include "../puzzle15.hpp"
+#include "korf15.hpp"
+#include "../pdb15.hpp"
+#include "../pdb_file15.hpp"
+#include "../solver15.hpp"
+#include "../batch_solver15.hpp"
+#include "../low_memory_solver15.hpp"
+#include "../../sliding/generator.hpp"
+
+// 再現できるベンチマーク（コミット間の性能の比較用）
+// 問題集は固定のシードから作るので、いつ実行しても同じ盤面を同じ順に解く。
+//   random:<手数>:<問題数>  目標盤面から <手数> 手のランダムウォークで作った盤面（シードは BENCH_SEED と手数で決まる）
+//   uniform:<問題数>        目標盤面から行ける盤面を一様に選んだもの（最適解は平均 53 手ほどと難しい。pdb 向け）
+//   korf:<最初>-<最後>      Korf の問題集の該当範囲
+// 各問題をウォームアップで数回解いてから、繰り返し回数だけ解いて 1 回ごとの時間をナノ秒で測る。
+// 問題集ごとに中央値 / p95 / p99 の解く時間、生成ノード毎秒、ピーク RSS を CSV か JSON（拡張子で決める）に書き出す。
+//
+// ./bench <ida|a|pea|fa|batch> <manhattan|linear|wd|pdb663|pdb78> <出力ファイル> <繰り返し回数> <ウォームアップ回数> [問題集...]
+//   問題集を省略すると random:20:100 random:35:50 random:50:20 を解く
+
+constexpr uint32_t BENCH_SEED = 20240501;
+
+struct Suite {
+    std::string name;
+    std::vector<puzzle15::Puzzle> problems;
+};
+
+struct SuiteStats {
+    std::string name;
+    std::size_t problems = 0;
+    std::size_t runs = 0;         // 問題数 x 繰り返し回数
+    std::size_t solved = 0;       // 最後の繰り返しで解けた問題数
+    std::size_t length_total = 0; // 最後の繰り返しの解の長さの合計
+    std::size_t generated = 0;    // 1 回の繰り返しの生成ノード数（どの繰り返しでも同じ）
+    long long median_ns = 0, p95_ns = 0, p99_ns = 0, max_ns = 0;
+    long long total_ns = 0;       // 全繰り返しの合計
+    double nodes_per_sec = 0;
+    long peak_rss_kb = 0;         // この問題集を解き終えた時点のピーク RSS
+};
+
+static bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// プロセス全体のピーク RSS (KB)
+static long peak_rss_kb() {
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+// 昇順に並べた値の p パーセンタイル（nearest-rank）
+static long long percentile(const std::vector<long long>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    std::size_t rank = static_cast<std::size_t>(p / 100.0 * sorted.size() + 0.999999);
+    rank = std::clamp<std::size_t>(rank, 1, sorted.size());
+    return sorted[rank - 1];
+}
+
+// "random:<手数>:<問題数>" / "uniform:<問題数>" / "korf:<最初>-<最後>" を問題集にする
+static Suite make_suite(const std::string& spec, const std::vector<puzzle15::Puzzle>& korf,
+                        const puzzle15::Puzzle& goal) {
+    Suite suite{spec, {}};
+    if (spec.rfind("random:", 0) == 0) {
+        int steps = 0, count = 0;
+        char colon = 0;
+        std::istringstream iss(spec.substr(7));
+        if (!(iss >> steps >> colon >> count) || colon != ':' || steps < 0 || count <= 0) {
+            throw std::invalid_argument("Invalid suite: " + spec + " (random:<steps>:<count>)");
+        }
+        std::mt19937 rng(BENCH_SEED + static_cast<uint32_t>(steps));
+        for (int i = 0; i < count; ++i) suite.problems.push_back(sliding::random_walk(goal, steps, rng));
+        return suite;
+    }
+    if (spec.rfind("uniform:", 0) == 0) {
+        int count = 0;
+        std::istringstream iss(spec.substr(8));
+        if (!(iss >> count) || count <= 0) {
+            throw std::invalid_argument("Invalid suite: " + spec + " (uniform:<count>)");
+        }
+        std::mt19937 rng(BENCH_SEED);
+        for (int i = 0; i < count; ++i) suite.problems.push_back(sliding::random_solvable(rng, goal));
+        return suite;
+    }
+    if (spec.rfind("korf:", 0) == 0) {
+        int first = 0, last = 0;
+        char dash = 0;
+        std::istringstream iss(spec.substr(5));
+        if (!(iss >> first >> dash >> last) || dash != '-' || first < 1 || last > 100 || first > last) {
+            throw std::invalid_argument("Invalid suite: " + spec + " (korf:<first>-<last>, 1 <= first <= last <= 100)");
+        }
+        for (int i = first; i <= last; ++i) suite.problems.push_back(korf[i - 1]);
+        return suite;
+    }
+    throw std::invalid_argument("Unknown suite: " + spec + " (random:<steps>:<count> / uniform:<count> / korf:<first>-<last>)");
+}
+
+static void write_csv(std::ostream& os, const std::vector<SuiteStats>& stats) {
+    os << "suite,problems,runs,solved,length_total,generated,median_ns,p95_ns,p99_ns,max_ns,total_ns,"
+          "nodes_per_sec,peak_rss_kb\n";
+    for (const auto& s : stats) {
+        os << s.name << ',' << s.problems << ',' << s.runs << ',' << s.solved << ',' << s.length_total << ','
+           << s.generated << ',' << s.median_ns << ',' << s.p95_ns << ',' << s.p99_ns << ',' << s.max_ns << ','
+           << s.total_ns << ',' << static_cast<long long>(s.nodes_per_sec) << ',' << s.peak_rss_kb << '\n';
+    }
+}
+
+static void write_json(std::ostream& os, const std::vector<SuiteStats>& stats, const std::string& solver,
+                       const std::string& heur, int reps, int warmup) {
+    os << "{\n";
+    os << "  \"solver\": \"" << solver << "\",\n";
+    os << "  \"heuristic\": \"" << heur << "\",\n";
+    os << "  \"repetitions\": " << reps << ",\n";
+    os << "  \"warmup\": " << warmup << ",\n";
+    os << "  \"seed\": " << BENCH_SEED << ",\n";
+    os << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+    os << "  \"suites\": [\n";
+    for (std::size_t i = 0; i < stats.size(); ++i) {
+        const auto& s = stats[i];
+        os << "    {\"suite\": \"" << s.name << "\", \"problems\": " << s.problems << ", \"runs\": " << s.runs
+           << ", \"solved\": " << s.solved << ", \"length_total\": " << s.length_total
+           << ", \"generated\": " << s.generated << ", \"median_ns\": " << s.median_ns
+           << ", \"p95_ns\": " << s.p95_ns << ", \"p99_ns\": " << s.p99_ns << ", \"max_ns\": " << s.max_ns
+           << ", \"total_ns\": " << s.total_ns << ", \"nodes_per_sec\": " << static_cast<long long>(s.nodes_per_sec)
+           << ", \"peak_rss_kb\": " << s.peak_rss_kb << "}" << (i + 1 < stats.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 6) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <ida|a|pea|fa|batch> <heuristic> <output .csv|.json> <repetitions> <warmup> [suite...]\n";
+        return 1;
+    }
+    const std::string slv = argv[1];
+    const std::string heur = argv[2];
+    const std::string out_path = argv[3];
+    const int reps = std::atoi(argv[4]);
+    const int warmup = std::atoi(argv[5]);
+    std::vector<std::string> specs(argv + 6, argv + argc);
+    if (specs.empty()) specs = {"random:20:100", "random:35:50", "random:50:20"};
+
+    if (slv != "ida" && slv != "a" && slv != "pea" && slv != "fa" && slv != "batch") {
+        std::cerr << "Unknown solver: " << slv << " (ida / a / pea / fa / batch)\n";
+        return 1;
+    }
+    if (!puzzle15::find_heuristic(heur)) {
+        std::cerr << "Unknown heuristic: " << heur << " (" << puzzle15::heuristic_names() << ")\n";
+        return 1;
+    }
+    if (reps < 1 || warmup < 0) {
+        std::cerr << "Repetitions must be >= 1 and warmup >= 0\n";
+        return 1;
+    }
+    const bool json = ends_with(out_path, ".json");
+    if (!json && !ends_with(out_path, ".csv")) {
+        std::cerr << "Output file must end with .csv or .json\n";
+        return 1;
+    }
+
+    // random の問題集も Korf の目標盤面（空白が左上）から作るので、評価器の初期化は 1 回で済む
+    auto korf = korf15::load_korf_problems("15-puzzle-states.txt");
+    const auto goal = korf[100];
+
+    std::vector<Suite> suites;
+    try {
+        for (const auto& spec : specs) suites.push_back(make_suite(spec, korf, goal));
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    puzzle15::init_heuristic(heur, goal);
+    sliding::MovePruningFsm<puzzle15::Puzzle::ROWS, puzzle15::Puzzle::COLS>::instance(); // IDA* / fa の初回の構築を測らない
+
+    solver15::SearchContext<> ctx; // A* の作業領域（全問題で使い回す）
+    auto solve = [&](const puzzle15::Puzzle& p) {
+        return puzzle15::with_heuristic(heur, [&](auto h) {
+            using H = decltype(h);
+            if (slv == "ida") return solver15::IDA_star_path(p, goal, h);
+            if (slv == "pea") return solver15::PEA_star_path(p, goal, h);
+            if (slv == "fa") return solver15::frontier_A_star_path(p, goal, h);
+            if (slv == "batch") {
+                if constexpr (sliding::is_batch_heuristic_v<H, puzzle15::Puzzle>) {
+                    return solver15::A_star_batch_path(p, goal, h);
+                } else {
+                    throw std::invalid_argument("batch solver needs manhattan or pdb heuristic");
+                }
+            }
+            return solver15::A_star_path(ctx, p, goal, h);
+        });
+    };
+
+    std::vector<SuiteStats> stats;
+    try {
+        for (const auto& suite : suites) {
+            SuiteStats s;
+            s.name = suite.name;
+            s.problems = suite.problems.size();
+            std::vector<long long> times;
+            times.reserve(suite.problems.size() * reps);
+
+            for (const auto& p : suite.problems) {
+                for (int w = 0; w < warmup; ++w) solve(p);
+                for (int r = 0; r < reps; ++r) {
+                    auto t0 = std::chrono::steady_clock::now();
+                    const auto result = solve(p);
+                    auto t1 = std::chrono::steady_clock::now();
+                    times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+                    if (r + 1 == reps) {
+                        s.solved += result.path.has_value();
+                        s.length_total += result.path ? result.path->size() : 0;
+                        s.generated += result.generated;
+                    }
+                }
+            }
+
+            s.runs = times.size();
+            for (long long t : times) s.total_ns += t;
+            std::sort(times.begin(), times.end());
+            s.median_ns = percentile(times, 50);
+            s.p95_ns = percentile(times, 95);
+            s.p99_ns = percentile(times, 99);
+            s.max_ns = times.back();
+            s.nodes_per_sec = s.total_ns > 0 ? static_cast<double>(s.generated) * reps / (s.total_ns / 1e9) : 0;
+            s.peak_rss_kb = peak_rss_kb();
+
+            std::cout << s.name << ": solved " << s.solved << " / " << s.problems << ", median " << s.median_ns / 1000
+                      << " us, p95 " << s.p95_ns / 1000 << " us, p99 " << s.p99_ns / 1000 << " us, "
+                      << static_cast<long long>(s.nodes_per_sec) << " nodes/s, peak RSS " << s.peak_rss_kb
+                      << " KB\n";
+            stats.push_back(s);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    std::ofstream ofs(out_path);
+    if (!ofs) {
+        std::cerr << "Failed to open " << out_path << "\n";
+        return 1;
+    }
+    if (json) write_json(ofs, stats, slv, heur, reps, warmup);
+    else write_csv(ofs, stats);
+    std::cout << "Results written to " << out_path << "\n";
+    return 0;
+}
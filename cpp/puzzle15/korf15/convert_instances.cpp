@@ -0,0 +1,51 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include "instance_io15.hpp"
+
+// 問題ファイルをテキスト形式とバイナリ形式の間で変換する
+// 出力ファイルの拡張子が .bin ならバイナリ形式、それ以外なら「番号 t0 ... t15」のテキスト形式で書く。
+// 入力の形式は先頭の magic で判定する（どちらでもよい）。盤面は読むときにすべて検査する。
+//
+// ./convert <入力ファイル> <出力ファイル>
+
+static bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <input file> <output file (.bin for binary)>\n";
+        return 1;
+    }
+    const std::string in_path = argv[1];
+    const std::string out_path = argv[2];
+
+    try {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t count = 0;
+        if (ends_with(out_path, ".bin")) {
+            korf15::BinaryInstanceWriter writer(out_path);
+            korf15::for_each_instance(in_path, [&](const puzzle15::Puzzle& p) { writer.push(p); });
+            writer.close();
+            count = writer.count();
+        } else {
+            std::ofstream ofs(out_path);
+            if (!ofs) throw std::runtime_error("Failed to open " + out_path);
+            korf15::for_each_instance(in_path, [&](const puzzle15::Puzzle& p) {
+                ofs << ++count;
+                for (int i = 0; i < 16; ++i) ofs << ' ' << static_cast<int>(p.get(i));
+                ofs << '\n';
+            });
+            if (!ofs.flush()) throw std::runtime_error("Failed to write " + out_path);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        std::cout << "Converted " << count << " instances to " << out_path << " in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << " ms\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include "korf15.hpp"
+#include "../../sliding/generator.hpp"
+
+// 負荷試験用に問題ファイルを作る（目標盤面は Korf の問題集と同じく空白が左上）
+//   uniform : 目標盤面から行ける盤面を一様に選ぶ（sliding::random_solvable）
+//   walk    : 目標盤面から <手数> 手のランダムウォーク（sliding::fast_random_walk）
+// 同じシードなら同じ問題列になる。出力ファイルの拡張子が .bin ならバイナリ形式、それ以外はテキスト形式。
+//
+// ./generate <uniform|walk> <問題数> <シード> <出力ファイル> [手数]
+
+static bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " <uniform|walk> <count> <seed> <output file (.bin for binary)> [steps]\n";
+        return 1;
+    }
+    const std::string mode = argv[1];
+    const long long count = std::atoll(argv[2]);
+    const uint32_t seed = static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10));
+    const std::string out_path = argv[4];
+    const int steps = argc >= 6 ? std::atoi(argv[5]) : 60;
+
+    if (mode != "uniform" && mode != "walk") {
+        std::cerr << "Unknown mode: " << mode << " (uniform / walk)\n";
+        return 1;
+    }
+    if (count < 0 || steps < 0) {
+        std::cerr << "Count and steps must be >= 0\n";
+        return 1;
+    }
+
+    const auto goal = korf15::korf_goal();
+
+    std::mt19937 rng(seed);
+    uint64_t state = seed;
+    auto next = [&] {
+        if (mode == "uniform") return sliding::random_solvable(rng, goal);
+        return sliding::fast_random_walk(goal, steps, state);
+    };
+
+    try {
+        auto t0 = std::chrono::steady_clock::now();
+        if (ends_with(out_path, ".bin")) {
+            korf15::BinaryInstanceWriter writer(out_path);
+            for (long long i = 0; i < count; ++i) writer.push(next());
+            writer.close();
+        } else {
+            std::ofstream ofs(out_path);
+            if (!ofs) throw std::runtime_error("Failed to open " + out_path);
+            for (long long i = 0; i < count; ++i) {
+                const auto p = next();
+                ofs << i + 1;
+                for (int c = 0; c < 16; ++c) ofs << ' ' << static_cast<int>(p.get(c));
+                ofs << '\n';
+            }
+            if (!ofs.flush()) throw std::runtime_error("Failed to write " + out_path);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        const double sec = std::chrono::duration<double>(t1 - t0).count();
+        std::cout << "Generated " << count << " instances to " << out_path << " in "
+                  << static_cast<long long>(sec * 1000) << " ms (" << static_cast<long long>(count / sec)
+                  << " instances/s)\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
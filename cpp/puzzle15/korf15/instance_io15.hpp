@@ -0,0 +1,262 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../puzzle15.hpp"
+
+// 15パズルの問題ファイルの読み書き（何百万問を流し込んでも読み込みが律速にならないように）
+//
+// テキスト形式: 1 行 1 問。「番号 t0 t1 ... t15」（Korf の問題集と同じ）か、番号なしの「t0 ... t15」。空白は 0
+// バイナリ形式: 16 バイトのヘッダ（magic "P15I" 8 バイト + 問題数 8 バイト）のあとに
+//               1 問 9 バイト（盤面の格納値 8 バイト + 空白の位置 1 バイト、リトルエンディアン）を並べる
+//
+// どちらもファイルを mmap して先頭から 1 問ずつ取り出す（全体を vector に読み込まない）。
+// テキストは istream を通さず、数字を直接読む。どちらの形式でも、各値 0..15 がちょうど一度ずつ現れない盤面は例外にする。
+
+namespace korf15 {
+
+constexpr char INSTANCE_MAGIC[8] = {'P', '1', '5', 'I', '\0', '\0', '\0', '\0'};
+constexpr std::size_t INSTANCE_HEADER = 16;   // magic 8 バイト + 問題数 8 バイト
+constexpr std::size_t INSTANCE_RECORD = 9;    // 格納値 8 バイト + 空白の位置 1 バイト
+constexpr std::size_t INSTANCE_BUFFER = 1 << 20; // 書き込みのバッファ
+
+// 各値 0..15 がちょうど一度ずつ現れ、zero が 0 のセルを指しているか
+inline bool valid_tiles(uint64_t packed, uint8_t zero) noexcept {
+    uint32_t seen = 0;
+    for (int i = 0; i < 16; ++i) seen |= 1u << ((packed >> (4 * i)) & 0xF);
+    return seen == 0xFFFF && zero < 16 && ((packed >> (4 * zero)) & 0xF) == 0;
+}
+
+// 読み取り専用の mmap（空のファイルは size() == 0）
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Failed to open " + path);
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat " + path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Failed to mmap " + path);
+            }
+            ::madvise(p, size_, MADV_SEQUENTIAL); // 先読みを多めにしてもらう
+            data_ = static_cast<const char*>(p);
+        }
+        ::close(fd); // 写像はファイルを閉じても残る
+    }
+    ~MappedFile() {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// テキスト形式を先頭から 1 問ずつ読む
+class TextInstanceReader {
+public:
+    explicit TextInstanceReader(const std::string& path)
+        : path_(path), file_(path), cur_(file_.data()), end_(file_.data() + file_.size()) {}
+
+    // 次の問題を p に入れる（終わりなら false）。形式が崩れた行や正しくない盤面は例外
+    bool next(puzzle15::Puzzle& p) {
+        for (;;) {
+            if (cur_ == end_) return false;
+            ++line_;
+            uint32_t values[17];
+            int n = 0;
+            while (cur_ != end_ && *cur_ != '\n') {
+                const char c = *cur_;
+                if (c == ' ' || c == '\t' || c == '\r') {
+                    ++cur_;
+                    continue;
+                }
+                if (c < '0' || c > '9' || n == 17) fail("Malformed line");
+                uint32_t v = 0;
+                while (cur_ != end_ && *cur_ >= '0' && *cur_ <= '9') {
+                    v = v * 10 + static_cast<uint32_t>(*cur_ - '0');
+                    if (v > 0xFFFFFF) fail("Number too large");
+                    ++cur_;
+                }
+                values[n++] = v;
+            }
+            if (cur_ != end_) ++cur_; // 改行
+            if (n == 0) continue;     // 空行
+            if (n != 16 && n != 17) fail("Expected 16 tiles");
+
+            const uint32_t* tiles = values + (n - 16); // 17 個なら先頭は問題番号
+            p.packed = 0;
+            for (int i = 0; i < 16; ++i) {
+                if (tiles[i] > 15) fail("Tile out of range");
+                puzzle15::Puzzle::set_nibble(p.packed, i, static_cast<uint8_t>(tiles[i]));
+                if (tiles[i] == 0) p.zero_pos = static_cast<uint8_t>(i);
+            }
+            if (!valid_tiles(p.packed, p.zero_pos)) fail("Each tile 0..15 must appear exactly once");
+            return true;
+        }
+    }
+
+    std::size_t line() const noexcept { return line_; } // 直前に読んだ行番号（1-based）
+
+private:
+    std::string path_;
+    MappedFile file_;
+    const char* cur_;
+    const char* end_;
+    std::size_t line_ = 0;
+
+    [[noreturn]] void fail(const char* what) const {
+        throw std::invalid_argument(std::string(what) + " at line " + std::to_string(line_) + " of " + path_);
+    }
+};
+
+// バイナリ形式を先頭から 1 問ずつ読む
+class BinaryInstanceReader {
+public:
+    explicit BinaryInstanceReader(const std::string& path) : path_(path), file_(path) {
+        if (file_.size() < INSTANCE_HEADER || std::memcmp(file_.data(), INSTANCE_MAGIC, 8) != 0) {
+            throw std::invalid_argument("Not an instance file: " + path);
+        }
+        std::memcpy(&count_, file_.data() + 8, 8);
+        // count_ * INSTANCE_RECORD は桁あふれしうるので、ファイルの大きさから問題数を求めて比べる
+        const std::size_t body = file_.size() - INSTANCE_HEADER;
+        if (body % INSTANCE_RECORD != 0 || count_ != body / INSTANCE_RECORD) {
+            throw std::invalid_argument("Truncated instance file: " + path);
+        }
+        cur_ = file_.data() + INSTANCE_HEADER;
+    }
+
+    uint64_t count() const noexcept { return count_; }
+
+    // 次の問題を p に入れる（終わりなら false）
+    bool next(puzzle15::Puzzle& p) {
+        if (read_ == count_) return false;
+        std::memcpy(&p.packed, cur_, 8);
+        p.zero_pos = static_cast<uint8_t>(cur_[8]);
+        if (!valid_tiles(p.packed, p.zero_pos)) {
+            throw std::invalid_argument("Invalid board at record " + std::to_string(read_) + " of " + path_);
+        }
+        cur_ += INSTANCE_RECORD;
+        ++read_;
+        return true;
+    }
+
+private:
+    std::string path_;
+    MappedFile file_;
+    const char* cur_ = nullptr;
+    uint64_t count_ = 0;
+    uint64_t read_ = 0;
+};
+
+// バイナリ形式で書く（close で先頭のヘッダに問題数を書き込む）
+// 一時ファイルに書いて close で rename するので、close まで進まなければ path には何も残らない
+class BinaryInstanceWriter {
+public:
+    explicit BinaryInstanceWriter(const std::string& path)
+        : path_(path), tmp_(path + ".tmp." + std::to_string(::getpid())) {
+        fp_ = std::fopen(tmp_.c_str(), "wb");
+        if (!fp_) throw std::runtime_error("Failed to create " + tmp_);
+        buf_.reserve(INSTANCE_BUFFER + INSTANCE_RECORD);
+        buf_.resize(INSTANCE_HEADER); // ヘッダは close で書き直す
+    }
+    ~BinaryInstanceWriter() {
+        if (fp_) { // close されなかった（例外など）
+            std::fclose(fp_);
+            std::remove(tmp_.c_str());
+        }
+    }
+    BinaryInstanceWriter(const BinaryInstanceWriter&) = delete;
+    BinaryInstanceWriter& operator=(const BinaryInstanceWriter&) = delete;
+
+    void push(const puzzle15::Puzzle& p) {
+        const std::size_t at = buf_.size();
+        buf_.resize(at + INSTANCE_RECORD);
+        std::memcpy(buf_.data() + at, &p.packed, 8);
+        buf_[at + 8] = p.zero_pos;
+        ++count_;
+        if (buf_.size() >= INSTANCE_BUFFER) flush();
+    }
+
+    uint64_t count() const noexcept { return count_; }
+
+    void close() {
+        flush();
+        uint8_t hdr[INSTANCE_HEADER];
+        std::memcpy(hdr, INSTANCE_MAGIC, 8);
+        std::memcpy(hdr + 8, &count_, 8);
+        if (std::fseek(fp_, 0, SEEK_SET) != 0 || std::fwrite(hdr, 1, INSTANCE_HEADER, fp_) != INSTANCE_HEADER
+            || std::fflush(fp_) != 0) {
+            fail();
+        }
+        const int rc = std::fclose(fp_);
+        fp_ = nullptr;
+        if (rc != 0 || std::rename(tmp_.c_str(), path_.c_str()) != 0) {
+            std::remove(tmp_.c_str());
+            throw std::runtime_error("Failed to write " + path_);
+        }
+    }
+
+private:
+    std::string path_;
+    std::string tmp_;
+    std::FILE* fp_ = nullptr;
+    std::vector<uint8_t> buf_;
+    uint64_t count_ = 0;
+
+    void flush() {
+        if (!buf_.empty() && std::fwrite(buf_.data(), 1, buf_.size(), fp_) != buf_.size()) fail();
+        buf_.clear();
+    }
+    [[noreturn]] void fail() {
+        std::fclose(fp_);
+        fp_ = nullptr;
+        std::remove(tmp_.c_str());
+        throw std::runtime_error("Failed to write " + path_);
+    }
+};
+
+// 先頭の magic でバイナリ形式かを判定する
+inline bool is_binary_instance_file(const std::string& path) {
+    std::FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) throw std::runtime_error("Failed to open " + path);
+    char magic[8] = {};
+    const bool binary = std::fread(magic, 1, 8, fp) == 8 && std::memcmp(magic, INSTANCE_MAGIC, 8) == 0;
+    std::fclose(fp);
+    return binary;
+}
+
+// ファイルの形式を見て、問題を 1 つずつ f(const Puzzle&) に渡す
+template <class F>
+inline void for_each_instance(const std::string& path, F&& f) {
+    puzzle15::Puzzle p;
+    if (is_binary_instance_file(path)) {
+        BinaryInstanceReader reader(path);
+        while (reader.next(p)) f(p);
+    } else {
+        TextInstanceReader reader(path);
+        while (reader.next(p)) f(p);
+    }
+}
+
+} // namespace korf15
@@ -2,43 +2,33 @@
 #include <vector>
 #include <array>
 #include <string>
-#include <fstream>
-#include <sstream>
 #include <stdexcept>
 #include "../puzzle15.hpp"
+#include "../../sliding/solvability.hpp"
+#include "instance_io15.hpp"
 
 namespace korf15 {
 
+// Korf の問題集の目標盤面（空白が左上、タイルは 1..15 の順。問題ファイルの 101 行目と同じ）
+inline puzzle15::Puzzle korf_goal() noexcept {
+    std::array<uint8_t, 16> tiles{};
+    for (int i = 0; i < 16; ++i) tiles[i] = static_cast<uint8_t>(i);
+    return puzzle15::Puzzle::from_tiles(tiles);
+}
+
 // Korfの15パズル問題集を読み込む
+// テキスト形式・バイナリ形式のどちらでもよい（instance_io15.hpp）。
+// 正しくない盤面や、korf_goal() へ行けない（偶奇が違う）盤面があれば例外を投げる
 inline std::vector<puzzle15::Puzzle> load_korf_problems(const std::string &filename) {
-    std::ifstream ifs(filename);
-    if (!ifs) {
-        throw std::runtime_error("Failed to open " + filename); // 例外を投げる
-    }
-
+    const puzzle15::Puzzle goal = korf_goal();
     std::vector<puzzle15::Puzzle> problems;
-    std::string line;
-    while (std::getline(ifs, line)) {
-        if (line.empty()) continue;
-        std::istringstream iss(line);
-        int idx;
-        iss >> idx; // 問題のインデックスを読み飛ばす
-        std::array<uint8_t, 16> tiles{};
-        for (int i = 0; i < 16; ++i) {
-            int v;
-            iss >> v;
-            tiles[i] = static_cast<uint8_t>(v); // 8ビット整数に変換
-        }
-        puzzle15::Puzzle p;
-        p.packed = 0;
-        for (int i = 0; i < 16; ++i) {
-            puzzle15::Puzzle::set_nibble(p.packed, i, tiles[i]); // 4ビットごとに詰める
-            if (tiles[i] == 0) {
-                p.zero_pos = static_cast<uint8_t>(i); // ゼロタイルの位置を記録
-            }
+    for_each_instance(filename, [&](const puzzle15::Puzzle& p) {
+        if (!sliding::is_solvable(p, goal)) {
+            throw std::invalid_argument("Problem " + std::to_string(problems.size() + 1) + " of " + filename +
+                                        " is unsolvable (parity differs from the goal)");
         }
         problems.push_back(p);
-    }
+    });
     return problems;
 }
 
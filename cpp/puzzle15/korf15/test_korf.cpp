@@ -7,11 +7,14 @@
 #include <chrono>
 #include "../puzzle15.hpp"
 #include "korf15.hpp"
+#include "../pdb15.hpp"
+#include "../pdb_file15.hpp"
 #include "../solver15.hpp"
+#include "../parallel_solver15.hpp"
+#include "../low_memory_solver15.hpp"
 #include "../generator15.hpp"
 
 int main(int argc, char* argv[]) {
-    puzzle15::init_manhattan_table(); // マンハッタン距離のテーブルを初期化
     std::mt19937 rng(std::random_device{}()); // 乱数生成器
 
     // 100個の盤面を生成してA*(IDA*) Searchを実行
@@ -27,6 +30,7 @@ int main(int argc, char* argv[]) {
 
     int num = 0;
     std::string slv = "ida"; // デフォルトのソルバーはIDA*
+    std::string heur = "manhattan"; // デフォルトのヒューリスティックはマンハッタン距離
     if (argc >= 2) {
         num = std::atoi(argv[1]) - 1; // argv[1]をintに変換（1-based指定 → 0-basedに変換）
     }
@@ -35,11 +39,36 @@ int main(int argc, char* argv[]) {
         slv = argv[2];
     }
 
+    if (argc >= 4) {
+        heur = argv[3]; // manhattan / linear / wd / pdb663 / pdb78
+    }
+
     if (num < 0 || num >= static_cast<int>(problems.size())) {
         std::cerr << "Invalid problem number. Please specify between 1 and " 
                   << problems.size() << ".\n";
         return 1;
     }
+    if (slv != "ida" && slv != "pida" && slv != "a" && slv != "pea" && slv != "fa") {
+        std::cerr << "Unknown solver: " << slv << " (ida / pida / a / pea / fa)\n";
+        return 1;
+    }
+    // 4 番目以降の引数の意味はソルバーで変わる
+    //   pida: <スレッド数> <フロンティアの深さ>, ida: <置換表の大きさ (MB)>
+    solver15::ParallelOptions popt; // pida のときのスレッド数とフロンティアの深さ
+    std::size_t tt_mb = 0; // ida のときの置換表の大きさ（MB, 0 なら使わない）
+    if (slv == "pida") {
+        if (argc >= 5) popt.threads = static_cast<unsigned>(std::atoi(argv[4]));
+        if (argc >= 6) popt.frontier_depth = std::atoi(argv[5]);
+    } else if (slv == "ida") {
+        if (argc >= 5) tt_mb = static_cast<std::size_t>(std::atoll(argv[4]));
+        if (argc >= 6) {
+            std::cerr << "Too many arguments for ida (<table MB>)\n";
+            return 1;
+        }
+    } else if (argc >= 5) {
+        std::cerr << "Solver " << slv << " takes no extra arguments (threads are for pida, table MB for ida)\n";
+        return 1;
+    }
 
     // 解く問題を表示
     std::cout << "Problem " << num + 1 << ":\n";
@@ -56,28 +85,62 @@ int main(int argc, char* argv[]) {
     }
 
 
-    if (slv == "ida") {
-        auto result = solver15::IDA_star_path(problems[num], goal);
+    // パターンデータベースはカレントディレクトリの PDB ファイルを mmap する（無ければ初回のみ構築して保存）
+    if (!puzzle15::find_heuristic(heur)) {
+        std::cerr << "Unknown heuristic: " << heur << " (" << puzzle15::heuristic_names() << ")\n";
+        return 1;
+    }
+    {
+        auto tb0 = std::chrono::steady_clock::now();
+        puzzle15::init_heuristic(heur, goal);
+        auto tb1 = std::chrono::steady_clock::now();
+        std::cout << "Initialized " << heur << " in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(tb1 - tb0).count() << " ms\n";
+    }
+
+    auto record = [&](const solver15::SearchResult& result) {
+        if (result.initial_bound >= 0) std::cout << "Initial bound: " << result.initial_bound << "\n";
+        if (result.stored > 0) std::cout << "Stored states: " << result.stored << "\n";
+        if constexpr (sliding::SEARCH_STATS_ENABLED) std::cout << result.stats.to_string(); // -DSLIDING_SEARCH_STATS=1 のとき
+        for (std::size_t t = 0; t < result.generated_per_thread.size(); ++t) {
+            std::cout << "Thread " << t << " generated: " << result.generated_per_thread[t] << "\n";
+        }
         if (result.path) {
             generated_total += result.generated;
             elapsed_total += result.elapsed_ms;
             path_length_total += result.path->size();
             successful_tests++;
         }
+    };
+
+    // ヒューリスティックは名前から対応表で選ぶ（探索器は評価器の型ごとに実体化される）
+    if (slv == "ida") {
+        record(puzzle15::with_heuristic(heur, [&](auto h) { return solver15::IDA_star_path(problems[num], goal, h, tt_mb); }));
+    }
+
+    if (slv == "pida") {
+        record(puzzle15::with_heuristic(heur, [&](auto h) { return solver15::parallel_IDA_star_path(problems[num], goal, h, popt); }));
     }
 
     if (slv == "a") {
-        auto result = solver15::A_star_path(problems[num], goal);
-        if (result.path) {
-            generated_total += result.generated;
-            elapsed_total += result.elapsed_ms;
-            path_length_total += result.path->size();
-            successful_tests++;
-        }
+        record(puzzle15::with_heuristic(heur, [&](auto h) { return solver15::A_star_path(problems[num], goal, h); }));
+    }
+
+    // メモリを抑えた A*（部分展開 A* / フロンティア A*）
+    if (slv == "pea") {
+        record(puzzle15::with_heuristic(heur, [&](auto h) { return solver15::PEA_star_path(problems[num], goal, h); }));
+    }
+
+    if (slv == "fa") {
+        record(puzzle15::with_heuristic(heur, [&](auto h) { return solver15::frontier_A_star_path(problems[num], goal, h); }));
     }
 
     // 平均値の出力
     std::cout << slv << " Search Results:\n";
+    if (successful_tests == 0) { // 解が得られなかったときは平均を出さない（0 で割らない）
+        std::cout << "No solution found\n";
+        return 1;
+    }
     std::cout << "Generated nodes: " << (generated_total / successful_tests) << "\n";
     std::cout << "Elapsed time: " << (elapsed_total / successful_tests) << " ms\n";
     std::cout << "Path length: " << (path_length_total / successful_tests) << "\n";
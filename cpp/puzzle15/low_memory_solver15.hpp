@@ -0,0 +1,314 @@
+#pragma once
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include "solver15.hpp"
+
+// メモリを抑えた A* の変種
+//
+// PEA_star_path: 部分展開 A* (Partial Expansion A*, Yoshizumi, Miura, Ishida 2000)
+//   展開するノードの子のうち、f が親の格納値 F に等しいものだけを表とオープンリストに入れ、
+//   親は F より大きい子の f の最小値を新しい F にしてオープンリストに戻す（大きい子が残っていなければ閉じる）。
+//   f が最適解の長さより大きい子は最後まで表に入らないので、A* が最も多く抱えるオープンのノードが減る。
+//   表のスロットの h には、h のかわりに格納値 F を置く。
+//   PDB のように無矛盾でない評価器では子の f が親の f より小さくなりうるので、そうした子は初回の展開で入れる。
+//
+// frontier_A_star_path: 部分展開つきのフロンティア探索 (Korf, Zhang, Thayer, Hohwald 2005) と分割統治の経路復元
+//   - 閉じたノードは表から消し、開いているノードだけを持つ。
+//     かわりに各ノードに「その手の先はもう生成しなくてよい」手のビットを持たせる
+//     （隣を生成するとき、隣の側に自分へ戻る手の印をつける）。スライディングパズルは無向グラフなので、
+//     消したノードがあとで再び生成されることはない。
+//   - 親へのポインタを持たないので、スタートから h(スタート)/2 手目の層（中継層）を通ったときの盤面を子へ引き継ぎ、
+//     ゴールに着いたらその盤面 m でスタート → m と m → ゴールの 2 つに分ける。
+//     スタート → m（ちょうど中継層の深さ）は m を目標にしたマンハッタン距離の IDA*、
+//     m → ゴールは同じ評価器で同じ分割を繰り返し、残りが短くなったら IDA* で解く。
+//   SearchResult::stored は、各回の探索で表に同時に載っていた状態の数の最大値。
+
+namespace solver15 {
+
+// 部分展開 A*
+template <class H = puzzle15::ManhattanHeuristic, class P = puzzle15::Puzzle>
+inline SearchResult
+PEA_star_path(const P& start,
+              const P& goal,
+              H heur = H{}) {
+    static_assert(sliding::is_incremental_heuristic_v<H, P>, "H must provide reset / update / undo");
+    using Puzzle = P;
+    using Move = sliding::Move;
+    using Key = typename P::Storage;
+    constexpr int MAX_DEPTH = P::Geometry::MAX_DEPTH;
+    static_assert(MAX_DEPTH + 1 <= 255, "g and F are stored as uint8_t in FlatStateTable");
+    if (!sliding::is_solvable(start, goal)) return unsolvable_result();
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto elapsed = [&] {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    };
+    std::size_t generated = 0;
+
+    if (start.packed == goal.packed) {
+        return SearchResult{std::make_optional(std::vector<Move>{}), generated, elapsed()};
+    }
+
+    // 第一キー F、第二キー F - g（同じ F なら深いノードから）
+    BucketPriorityQueue<Puzzle, TieBreak::Fifo, true> open(0, MAX_DEPTH + 2, 0, MAX_DEPTH + 2);
+    sliding::FlatStateTable<Key> table(1 << 20); // h には格納値 F を置く
+
+    const int hstart = heur.reset(start);
+    open.push(start, hstart, hstart);
+    {
+        auto& root = *table.insert(start.packed).first;
+        root.g = 0;
+        root.h = static_cast<uint8_t>(hstart);
+    }
+
+    while (!open.empty()) {
+        Puzzle s = open.top();
+        const int F = open.top_f();
+        open.pop();
+
+        auto* slot = table.find(s.packed);
+        if (slot->closed() || slot->h != F) continue; // 閉じた・F が変わった古いエントリ
+        const int g_cur = slot->g;
+        const std::optional<Move> prev_move = slot->move();
+
+        if (s.packed == goal.packed) {
+            std::vector<Move> path;
+            Puzzle x = s;
+            while (!(x.packed == start.packed)) {
+                const auto* ps = table.find(x.packed);
+                path.push_back(*ps->move());
+                x.undo_move_inplace(x.get(ps->prev_zero), ps->prev_zero);
+            }
+            std::reverse(path.begin(), path.end());
+            return SearchResult{std::make_optional(std::move(path)), generated, elapsed(), {}, table.size()};
+        }
+
+        const int h_parent = heur.reset(s);
+        const bool first = (F == g_cur + h_parent); // 初めての展開（F がまだ自分の f）
+        int next_f = std::numeric_limits<int>::max(); // F より大きい子の f の最小値
+        const auto& succ = P::Geometry::SUCCESSORS[s.zero_pos];
+        for (int k = 0; k < succ.count; ++k) {
+            const Move m = succ.move[k];
+            if (prev_move && m == inverse_move(*prev_move)) continue; // 即時バックトラック防止
+            const int old_zero = s.zero_pos;
+            const int new_zero = succ.to[k];
+            const uint8_t moved_tile = s.slide_blank(new_zero);
+            const int h_child = heur.update(h_parent, moved_tile, new_zero, old_zero);
+            const int g_child = g_cur + 1;
+            const int f_child = g_child + h_child;
+
+            if (f_child == F || (first && f_child < F)) {
+                auto [cs, inserted] = table.insert(s.packed);
+                if (inserted || g_child < cs->g) {
+                    cs->assign(g_child, f_child, m, old_zero);
+                    ++generated;
+                    open.push(s, f_child, h_child);
+                }
+            } else if (f_child > F) {
+                next_f = std::min(next_f, f_child); // 今回は入れない
+            }
+            // 2 回目以降の展開で f_child < F の子は、親の F がその値だったとき（または初回）に入れてある
+
+            heur.undo(moved_tile, new_zero, old_zero);
+            s.unslide_blank(moved_tile, old_zero);
+        }
+
+        slot = table.find(s.packed); // 挿入で表が伸びるとポインタは無効になる
+        if (next_f == std::numeric_limits<int>::max()) {
+            slot->set_closed();
+        } else {
+            slot->h = static_cast<uint8_t>(next_f);
+            open.push(s, next_f, next_f - g_cur);
+        }
+    }
+
+    return SearchResult{std::nullopt, generated, elapsed(), {}, table.size()};
+}
+
+namespace detail {
+
+// フロンティア探索の表のスロット
+template <class Key>
+struct FrontierSlot {
+    Key key;
+    uint32_t relay; // 通ってきた中継層の盤面（relays の添字。中継層より浅ければ NO_RELAY）
+    uint8_t g;
+    uint8_t f;      // 格納値 F（部分展開で上がる）
+    uint8_t used;   // bit m: 手 m の先は生成しない（その隣はすでに展開したか、自分を生成した）
+};
+
+inline constexpr uint32_t NO_RELAY = std::numeric_limits<uint32_t>::max();
+
+template <class Key>
+struct FrontierOutcome {
+    int cost = -1;             // 最短経路の長さ（見つからなければ -1）
+    std::optional<Key> relay;  // その経路が中継層で通った盤面
+    std::size_t generated = 0;
+    std::size_t peak = 0;      // 表に同時に載っていた状態の数の最大値
+};
+
+// start から goal への部分展開つきフロンティア探索。スタートから relay_depth 手目の盤面を覚えて返す
+template <class H, class P>
+inline FrontierOutcome<typename P::Storage>
+frontier_search(const P& start, const P& goal, H& heur, int relay_depth) {
+    using Puzzle = P;
+    using Move = sliding::Move;
+    using Key = typename P::Storage;
+    using Table = sliding::FlatTable<FrontierSlot<Key>>;
+    constexpr int MAX_DEPTH = P::Geometry::MAX_DEPTH;
+
+    FrontierOutcome<Key> out;
+    BucketPriorityQueue<Puzzle, TieBreak::Fifo, true> open(0, MAX_DEPTH + 2, 0, MAX_DEPTH + 2);
+    Table table(1 << 20);
+    std::vector<Key> relays;
+
+    const int hstart = heur.reset(start);
+    {
+        auto& root = *table.insert(start.packed).first;
+        root.g = 0;
+        root.f = static_cast<uint8_t>(hstart);
+        root.used = 0;
+        root.relay = NO_RELAY;
+        if (relay_depth == 0) {
+            root.relay = 0;
+            relays.push_back(start.packed);
+        }
+    }
+    open.push(start, hstart, hstart);
+
+    while (!open.empty()) {
+        Puzzle s = open.top();
+        const int F = open.top_f();
+        open.pop();
+
+        auto* slot = table.find(s.packed);
+        if (!slot || slot->f != F) continue; // 閉じて消した・F が変わった古いエントリ
+        const int g_cur = slot->g;
+        const uint32_t relay = slot->relay;
+        const uint8_t used = slot->used;
+
+        if (s.packed == goal.packed) {
+            out.cost = g_cur;
+            if (relay != NO_RELAY) out.relay = relays[relay];
+            return out;
+        }
+
+        const int h_parent = heur.reset(s);
+        const bool first = (F == g_cur + h_parent);
+        int next_f = std::numeric_limits<int>::max();
+        const auto& succ = P::Geometry::SUCCESSORS[s.zero_pos];
+        for (int k = 0; k < succ.count; ++k) {
+            const Move m = succ.move[k];
+            if (used & (1u << static_cast<int>(m))) continue;
+            const int old_zero = s.zero_pos;
+            const int new_zero = succ.to[k];
+            const uint8_t moved_tile = s.slide_blank(new_zero);
+            const int h_child = heur.update(h_parent, moved_tile, new_zero, old_zero);
+            const int g_child = g_cur + 1;
+            const int f_child = g_child + h_child;
+
+            if (f_child == F || (first && f_child < F)) {
+                const uint8_t back = static_cast<uint8_t>(1u << static_cast<int>(inverse_move(m)));
+                auto [cs, inserted] = table.insert(s.packed);
+                if (inserted || g_child < cs->g) {
+                    uint32_t r = relay;
+                    if (g_child == relay_depth) {
+                        r = static_cast<uint32_t>(relays.size());
+                        relays.push_back(s.packed);
+                    }
+                    cs->g = static_cast<uint8_t>(g_child);
+                    cs->f = static_cast<uint8_t>(f_child);
+                    cs->relay = r;
+                    cs->used = inserted ? back : static_cast<uint8_t>(cs->used | back);
+                    ++out.generated;
+                    open.push(s, f_child, h_child);
+                } else {
+                    cs->used |= back; // 子からこのノードへは戻らない
+                }
+            } else if (f_child > F) {
+                next_f = std::min(next_f, f_child);
+            }
+
+            heur.undo(moved_tile, new_zero, old_zero);
+            s.unslide_blank(moved_tile, old_zero);
+        }
+
+        out.peak = std::max(out.peak, table.size());
+        slot = table.find(s.packed);
+        if (next_f == std::numeric_limits<int>::max()) {
+            table.erase(slot); // 全部の子を生成し終えたら閉じて消す
+        } else {
+            slot->f = static_cast<uint8_t>(next_f);
+            open.push(s, next_f, next_f - g_cur);
+        }
+    }
+    return out;
+}
+
+} // namespace detail
+
+// フロンティア A*（部分展開つき）と分割統治による経路の復元
+template <class H = puzzle15::ManhattanHeuristic, class P = puzzle15::Puzzle>
+inline SearchResult
+frontier_A_star_path(const P& start,
+                     const P& goal,
+                     H heur = H{}) {
+    static_assert(sliding::is_incremental_heuristic_v<H, P>, "H must provide reset / update / undo");
+    using Puzzle = P;
+    using Move = sliding::Move;
+    // 残りの h がこれより小さければ分割せずに IDA* で解く
+    constexpr int MIN_SPLIT = 16;
+    if (!sliding::is_solvable(start, goal)) return unsolvable_result();
+    // 部分問題を解く IDA* のオートマトンは先に作っておく（探索時間には含めない）
+    sliding::MovePruningFsm<P::ROWS, P::COLS>::instance();
+
+    auto t0 = std::chrono::steady_clock::now();
+    SearchResult out;
+    std::vector<Move> path;
+
+    auto append = [&](const SearchResult& r) {
+        out.generated += r.generated;
+        if (r.path) path.insert(path.end(), r.path->begin(), r.path->end());
+        return r.path.has_value();
+    };
+
+    bool solved = true;
+    Puzzle s = start;
+    while (!(s.packed == goal.packed)) {
+        const int h = heur.reset(s);
+        if (h < MIN_SPLIT) {
+            solved = append(IDA_star_path(s, goal, heur));
+            break;
+        }
+
+        const int relay_depth = h / 2;
+        const auto found = detail::frontier_search(s, goal, heur, relay_depth);
+        out.generated += found.generated;
+        out.stored = std::max(out.stored, found.peak);
+        if (found.cost < 0 || !found.relay) { // 解なし
+            solved = false;
+            break;
+        }
+
+        // 中継層の盤面 m までは m を目標にしたマンハッタン距離の IDA* で（ちょうど relay_depth 手）
+        Puzzle m;
+        m.packed = *found.relay;
+        for (int i = 0; i < P::CELLS; ++i) {
+            if (m.get(i) == 0) m.zero_pos = static_cast<uint8_t>(i);
+        }
+        if (!append(IDA_star_path(s, m, sliding::ManhattanHeuristic<P>(m)))) {
+            solved = false;
+            break;
+        }
+        s = m;
+    }
+
+    if (solved) out.path = std::move(path);
+    out.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    return out;
+}
+
+} // namespace solver15
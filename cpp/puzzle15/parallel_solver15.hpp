@@ -0,0 +1,274 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <limits>
+#include <stdexcept>
+#include <optional>
+#include <chrono>
+#include "solver15.hpp"
+#include "../sliding/work_stealing_pool.hpp"
+#include "../sliding/move_pruning.hpp"
+
+// ルート分割による並列 IDA*
+//
+// 反復（閾値）ごとに、スタートから frontier_depth 手までを逐次に展開して f <= bound の節点を集め、
+// その下の部分木を 1 つずつ仕事としてワークスティーリングのスレッドプールに配る。
+// - 次の閾値候補（f 超過の最小値）は全スレッドで atomic に最小値を取る
+// - どこかのスレッドが現在の閾値で解を見つけたら stop を立て、他のスレッドは探索を打ち切る
+//   （閾値は f の最小超過値なので、同じ閾値で見つかった解はどれも最適）
+// - 生成ノード数はスレッドごとに数えて SearchResult::generated_per_thread に返す
+//   （フロンティアの展開は呼び出し元スレッド = ワーカー 0 の分に数える）
+
+namespace solver15 {
+
+struct ParallelOptions {
+    unsigned threads = 0;    // 0 なら std::thread::hardware_concurrency()
+    int frontier_depth = 12; // 反復ごとにこの深さまで展開した節点を仕事の単位にする
+};
+
+namespace detail {
+
+constexpr int IDA_FOUND = -1;     // 解を見つけた
+constexpr int IDA_CANCELLED = -2; // 他のスレッドが解を見つけたので打ち切った
+
+// atomic な最小値の更新
+inline void atomic_min(std::atomic<int>& a, int v) noexcept {
+    int cur = a.load(std::memory_order_relaxed);
+    while (v < cur && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+    }
+}
+
+// 1 スレッド分の部分木探索（IDA_star_path と同じ深さ優先探索を再帰で書き、打ち切り判定を足したもの）
+template <class H, class P>
+struct ParallelIdaWorker {
+    using Puzzle = P;
+    using Move = sliding::Move;
+    using Fsm = sliding::MovePruningFsm<P::ROWS, P::COLS>;
+    static constexpr int MAX_DEPTH = P::Geometry::MAX_DEPTH;
+
+    const Puzzle* goal;
+    const std::atomic<bool>* stop;
+    const Fsm* fsm;
+    H heur;
+    std::array<Move, MAX_DEPTH + 1> path{};
+    int depth = 0;
+    std::size_t generated = 0;
+
+    ParallelIdaWorker(const Puzzle& goal, const std::atomic<bool>& stop, const Fsm& fsm, const H& heur)
+        : goal(&goal), stop(&stop), fsm(&fsm), heur(heur) {}
+
+    int dfs(Puzzle& s, int g, int bound, int h, int fsm_state) {
+        const int f = g + h;
+        if (f > bound) return f;
+        if (s.packed == goal->packed) return IDA_FOUND;
+        if (stop->load(std::memory_order_relaxed)) return IDA_CANCELLED;
+
+        int min_next = std::numeric_limits<int>::max();
+
+        for (Move mv : sliding::MOVES) {
+            const int next_state = fsm->next(fsm_state, mv);
+            if (next_state < 0) {
+                continue; // 重複経路の枝刈り
+            }
+
+            uint8_t moved_tile = 0, old_zero = 0;
+            if (!s.apply_move_inplace(mv, moved_tile, old_zero)) {
+                continue;
+            }
+
+            const int new_zero = s.zero_pos;
+            const int h_child = heur.update(h, moved_tile, new_zero, old_zero);
+            const int f_child = (g + 1) + h_child;
+
+            ++generated;
+
+            if (f_child > bound) {
+                if (f_child < min_next) min_next = f_child;
+                heur.undo(moved_tile, new_zero, old_zero);
+                s.undo_move_inplace(moved_tile, old_zero);
+                continue;
+            }
+
+            path[depth++] = mv;
+
+            const int r = dfs(s, g + 1, bound, h_child, next_state);
+            if (r == IDA_FOUND || r == IDA_CANCELLED) return r; // 経路は path[0, depth) に残す
+            if (r < min_next) min_next = r;
+
+            --depth;
+            heur.undo(moved_tile, new_zero, old_zero);
+            s.undo_move_inplace(moved_tile, old_zero);
+        }
+        return min_next;
+    }
+};
+
+} // namespace detail
+
+// 並列 IDA*（pool を渡せばスレッドを使い回す。渡さなければこの呼び出しの間だけ作る）
+template <class H = puzzle15::ManhattanHeuristic, class P = puzzle15::Puzzle>
+inline SearchResult
+parallel_IDA_star_path(const P& start,
+                       const P& goal,
+                       H heur = H{},
+                       ParallelOptions opt = ParallelOptions{},
+                       sliding::WorkStealingPool* pool = nullptr) {
+    static_assert(sliding::is_incremental_heuristic_v<H, P>, "H must provide reset / update / undo");
+    using Puzzle = P;
+    using Move = sliding::Move;
+    using Worker = detail::ParallelIdaWorker<H, P>;
+    constexpr int MAX_DEPTH = P::Geometry::MAX_DEPTH;
+
+    if (opt.frontier_depth < 0 || opt.frontier_depth > MAX_DEPTH) {
+        throw std::invalid_argument("frontier_depth out of range");
+    }
+    if (!sliding::is_solvable(start, goal)) return unsolvable_result();
+
+    const auto& fsm = sliding::MovePruningFsm<P::ROWS, P::COLS>::instance(); // 重複経路の枝刈り（構築は最初の 1 回だけ）
+    std::optional<sliding::WorkStealingPool> own_pool;
+    if (!pool) pool = &own_pool.emplace(opt.threads);
+    const unsigned T = pool->size();
+
+    SearchResult out;
+    out.generated_per_thread.assign(T, 0);
+    auto t0 = std::chrono::steady_clock::now();
+    auto finish = [&]() -> SearchResult {
+        out.generated = 0;
+        for (std::size_t n : out.generated_per_thread) out.generated += n;
+        out.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+        return std::move(out);
+    };
+
+    if (start.packed == goal.packed) {
+        out.path = std::vector<Move>{};
+        out.generated_per_thread[0] = 1;
+        return finish();
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<Worker> workers(T, Worker(goal, stop, fsm, heur));
+
+    // フロンティア: frontier_depth 手目の節点の盤面・枝刈りオートマトンの状態と、そこまでの手順
+    struct FrontierNode {
+        Puzzle s;
+        int fsm_state;
+    };
+    const int D = opt.frontier_depth;
+    std::vector<FrontierNode> frontier;
+    std::vector<Move> prefixes; // frontier[i] の手順は prefixes[i*D, (i+1)*D)
+
+    const int h0 = heur.reset(start);
+    int bound = h0;
+    out.initial_bound = bound;
+
+    for (;;) {
+        frontier.clear();
+        prefixes.clear();
+        stop.store(false, std::memory_order_relaxed);
+        std::atomic<int> next_bound{std::numeric_limits<int>::max()};
+
+        // フロンティアの展開（呼び出し元スレッドで逐次に）。途中で解が見つかればそのまま返す
+        Worker& w0 = workers[0];
+        w0.depth = 0;
+        w0.heur = heur;
+        Puzzle s = start;
+        w0.heur.reset(s);
+
+        struct Expand {
+            Worker& w;
+            std::vector<FrontierNode>& frontier;
+            std::vector<Move>& prefixes;
+            const Puzzle& goal;
+            int D;
+            int bound;
+
+            int operator()(Puzzle& s, int g, int h, int fsm_state) {
+                const int f = g + h;
+                if (f > bound) return f;
+                if (s.packed == goal.packed) return detail::IDA_FOUND;
+                if (g == D) {
+                    frontier.push_back(FrontierNode{s, fsm_state});
+                    prefixes.insert(prefixes.end(), w.path.begin(), w.path.begin() + D);
+                    return std::numeric_limits<int>::max();
+                }
+
+                int min_next = std::numeric_limits<int>::max();
+                for (Move mv : sliding::MOVES) {
+                    const int next_state = w.fsm->next(fsm_state, mv);
+                    if (next_state < 0) continue;
+
+                    uint8_t moved_tile = 0, old_zero = 0;
+                    if (!s.apply_move_inplace(mv, moved_tile, old_zero)) continue;
+
+                    const int new_zero = s.zero_pos;
+                    const int h_child = w.heur.update(h, moved_tile, new_zero, old_zero);
+                    ++w.generated;
+
+                    w.path[w.depth++] = mv;
+                    const int r = (*this)(s, g + 1, h_child, next_state);
+                    if (r == detail::IDA_FOUND) return r;
+                    if (r < min_next) min_next = r;
+                    --w.depth;
+                    w.heur.undo(moved_tile, new_zero, old_zero);
+                    s.undo_move_inplace(moved_tile, old_zero);
+                }
+                return min_next;
+            }
+        };
+
+        w0.generated = 0;
+        const int r0 = Expand{w0, frontier, prefixes, goal, D, bound}(s, 0, h0, fsm.START);
+        out.generated_per_thread[0] += w0.generated;
+        w0.generated = 0;
+        if (r0 == detail::IDA_FOUND) {
+            out.path = std::vector<Move>(w0.path.begin(), w0.path.begin() + w0.depth);
+            return finish();
+        }
+        detail::atomic_min(next_bound, r0);
+
+        // 部分木を並列に探索する
+        std::mutex found_m;
+        std::optional<std::vector<Move>> found_path;
+
+        pool->run(frontier.size(), [&](unsigned id, std::size_t i) {
+            if (stop.load(std::memory_order_relaxed)) return;
+            Worker& w = workers[id];
+            const Move* prefix = prefixes.data() + i * D;
+
+            std::copy(prefix, prefix + D, w.path.begin());
+            w.depth = D;
+            Puzzle cur = frontier[i].s;
+            const int h = w.heur.reset(cur);
+
+            const int r = w.dfs(cur, D, bound, h, frontier[i].fsm_state);
+            if (r == detail::IDA_FOUND) {
+                std::lock_guard<std::mutex> lk(found_m);
+                if (!found_path) found_path = std::vector<Move>(w.path.begin(), w.path.begin() + w.depth);
+                stop.store(true, std::memory_order_relaxed);
+            } else if (r != detail::IDA_CANCELLED) {
+                detail::atomic_min(next_bound, r);
+            }
+        });
+
+        for (unsigned id = 0; id < T; ++id) {
+            out.generated_per_thread[id] += workers[id].generated;
+            workers[id].generated = 0;
+        }
+
+        if (found_path) {
+            out.path = std::move(found_path);
+            return finish();
+        }
+        const int nb = next_bound.load();
+        if (nb == std::numeric_limits<int>::max()) { // すべての子が閾値超過なら終了
+            out.path = std::nullopt;
+            return finish();
+        }
+        bound = nb;
+    }
+}
+
+} // namespace solver15
@@ -0,0 +1,329 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <initializer_list>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include "puzzle15.hpp"
+
+// 加算的な互いに素なパターンデータベース (Additive Disjoint Pattern Database)
+//
+// タイル集合をいくつかのパターンに分割し、各パターンについて
+// 「そのパターンのタイルだけを動かす手数」の最小値を目標状態からの後ろ向き BFS で求める。
+// パターン外のタイルの移動はコスト 0 とみなすので、各パターンの値を足し合わせても許容的。
+//
+// パターンは「目標盤面のセル集合」で指定し、目標盤面のそのセルにあるタイルがパターンとなる。
+// これにより空白の位置が異なる目標盤面 (Puzzle::goal() や Korf の目標) にもそのまま対応できる。
+
+namespace puzzle15 {
+
+// 16bit の popcount（-mpopcnt なしでもライブラリ呼び出しにならないよう SWAR で書く）
+static inline uint32_t popcount16(uint32_t x) noexcept {
+    x = x - ((x >> 1) & 0x5555u);
+    x = (x & 0x3333u) + ((x >> 2) & 0x3333u);
+    x = (x + (x >> 4)) & 0x0F0Fu;
+    return (x + (x >> 8)) & 0x1Fu;
+}
+
+// k 個のタイル位置 (0..15 の互いに異なる値) の完全ハッシュ
+// rank = Σ c_i * (15-i)(14-i)...(16-k+1)  ただし c_i は pos[i] より小さい未使用セルの数
+// 値域はちょうど 16!/(16-k)!
+inline uint32_t pattern_rank(const uint8_t* pos, int k) noexcept {
+    uint32_t r = 0;
+    uint32_t used = 0;
+    for (int i = 0; i < k; ++i) {
+        const uint32_t p = pos[i];
+        const uint32_t c = p - popcount16(used & ((1u << p) - 1u));
+        r = r * static_cast<uint32_t>(16 - i) + c;
+        used |= 1u << p;
+    }
+    return r;
+}
+
+inline uint64_t pattern_size(int k) noexcept {
+    uint64_t n = 1;
+    for (int i = 0; i < k; ++i) n *= static_cast<uint64_t>(16 - i);
+    return n;
+}
+
+// 1 つのパターンの距離テーブル
+// テーブル本体は構築時のメモリか mmap したファイルのどちらかで、storage が寿命を管理する
+struct PatternDatabase {
+    std::vector<uint8_t> tiles;          // パターンに含まれるタイル (k 個)
+    const uint8_t* dist = nullptr;       // rank → パターンタイルの移動回数の下界
+    uint64_t entries = 0;                // テーブルの要素数 (= 16!/(16-k)!)
+    std::shared_ptr<const void> storage; // dist の所有者
+
+    int size() const noexcept { return static_cast<int>(tiles.size()); }
+};
+
+// 空白を含まない 16bit のセル集合の中で、start から到達可能な領域を求める (flood fill)
+inline uint32_t blank_region(uint32_t start_bit, uint32_t free_cells) noexcept {
+    constexpr uint32_t NOT_COL0 = 0xEEEEu; // 左端列以外
+    constexpr uint32_t NOT_COL3 = 0x7777u; // 右端列以外
+    uint32_t r = start_bit;
+    for (;;) {
+        uint32_t n = r | (((r << 4) | (r >> 4) | ((r << 1) & NOT_COL0) | ((r >> 1) & NOT_COL3)) & free_cells & 0xFFFFu);
+        if (n == r) return r;
+        r = n;
+    }
+}
+
+// 目標盤面から後ろ向き BFS でパターンの距離テーブルを作る
+// 状態は (パターンタイルの位置, 空白が属する領域) で表し、領域内の空白移動はコスト 0 として畳み込む。
+// 訪問済みは rank ごとに「既に到達した空白セルの集合」(16bit) で持つので、重複判定に flood fill は要らない。
+inline PatternDatabase build_pattern_database(const Puzzle& goal, const std::vector<int>& cells) {
+    const int k = static_cast<int>(cells.size());
+    if (k <= 0 || k > 8) {
+        throw std::invalid_argument("pattern size must be in [1, 8]");
+    }
+
+    PatternDatabase db;
+    db.tiles.reserve(k);
+    std::array<uint8_t, 8> start_pos{};
+    for (int i = 0; i < k; ++i) {
+        const uint8_t t = goal.get(cells[i]);
+        if (t == 0) throw std::invalid_argument("pattern must not contain the blank cell");
+        db.tiles.push_back(t);
+        start_pos[i] = static_cast<uint8_t>(cells[i]);
+    }
+
+    const uint64_t n = pattern_size(k);
+    auto table = std::make_shared<std::vector<uint8_t>>(n, 0xFF);
+    uint8_t* dist = table->data();
+
+    // visited[rank] = その配置で既に到達した空白セルの集合
+    std::vector<uint16_t> visited(n, 0);
+
+    // キューの要素は位置 k 個 (4bit ずつ) と空白領域 (16bit) を詰めたもの（unrank が不要になる）
+    auto pack = [&](const uint8_t* pos, uint32_t region) {
+        uint64_t x = 0;
+        for (int i = 0; i < k; ++i) x |= static_cast<uint64_t>(pos[i]) << (i * 4);
+        return x | (static_cast<uint64_t>(region) << 32);
+    };
+
+    std::vector<uint64_t> cur, next;
+    {
+        uint32_t occ = 0;
+        for (int i = 0; i < k; ++i) occ |= 1u << start_pos[i];
+        const uint32_t region = blank_region(1u << goal.zero_pos, ~occ & 0xFFFFu);
+        const uint32_t r = pattern_rank(start_pos.data(), k);
+        visited[r] = static_cast<uint16_t>(region);
+        dist[r] = 0;
+        cur.push_back(pack(start_pos.data(), region));
+    }
+
+    constexpr int DR[4] = {-4, 4, -1, 1};
+
+    for (int d = 0; !cur.empty(); ++d) {
+        next.clear();
+        for (uint64_t x : cur) {
+            std::array<uint8_t, 8> pos{};
+            uint32_t occ = 0;
+            for (int i = 0; i < k; ++i) {
+                pos[i] = static_cast<uint8_t>((x >> (i * 4)) & 0xF);
+                occ |= 1u << pos[i];
+            }
+            const uint32_t region = static_cast<uint32_t>(x >> 32);
+            const uint32_t free_cells = ~occ & 0xFFFFu;
+
+            // パターンタイルを空白領域内の隣接セルへ動かす（コスト 1）
+            for (int i = 0; i < k; ++i) {
+                const int p = pos[i];
+                for (int dir = 0; dir < 4; ++dir) {
+                    const int q = p + DR[dir];
+                    if (q < 0 || q > 15) continue;
+                    if ((dir == 2 || dir == 3) && Puzzle::row(q) != Puzzle::row(p)) continue;
+                    if (!(region & (1u << q))) continue;
+
+                    pos[i] = static_cast<uint8_t>(q);
+                    const uint32_t r = pattern_rank(pos.data(), k);
+                    if (!(visited[r] & (1u << p))) {
+                        const uint32_t nfree = (free_cells | (1u << p)) & ~(1u << q);
+                        const uint32_t nregion = blank_region(1u << p, nfree);
+                        visited[r] = static_cast<uint16_t>(visited[r] | nregion);
+                        if (dist[r] == 0xFF) dist[r] = static_cast<uint8_t>(d + 1);
+                        next.push_back(pack(pos.data(), nregion));
+                    }
+                    pos[i] = static_cast<uint8_t>(p);
+                }
+            }
+        }
+        cur.swap(next);
+    }
+    db.dist = dist;
+    db.entries = n;
+    db.storage = std::move(table);
+    return db;
+}
+
+// 互いに素なパターンの組
+struct AdditivePDB {
+    std::string name;
+    std::vector<PatternDatabase> patterns;
+    std::array<int8_t, 16> tile_pattern{}; // タイル → パターン番号（空白は -1）
+    std::array<int8_t, 16> tile_slot{};    // タイル → パターン内の順番
+
+    void index_tiles() {
+        tile_pattern.fill(-1);
+        tile_slot.fill(-1);
+        for (int p = 0; p < static_cast<int>(patterns.size()); ++p) {
+            for (int i = 0; i < patterns[p].size(); ++i) {
+                tile_pattern[patterns[p].tiles[i]] = static_cast<int8_t>(p);
+                tile_slot[patterns[p].tiles[i]] = static_cast<int8_t>(i);
+            }
+        }
+    }
+
+    // tile_pos[t] = タイル t の位置 から 1 パターン分の値を引く
+    inline int lookup(int p, const uint8_t* tile_pos) const noexcept {
+        const PatternDatabase& db = patterns[p];
+        std::array<uint8_t, 8> pos{};
+        const int k = db.size();
+        for (int i = 0; i < k; ++i) pos[i] = tile_pos[db.tiles[i]];
+        return db.dist[pattern_rank(pos.data(), k)];
+    }
+
+    // 盤面 (packed) から直接評価する
+    inline int evaluate(const Puzzle& s) const noexcept {
+        std::array<uint8_t, 16> tile_pos{};
+        for (int i = 0; i < 16; ++i) tile_pos[s.get(i)] = static_cast<uint8_t>(i);
+        int h = 0;
+        for (int p = 0; p < static_cast<int>(patterns.size()); ++p) h += lookup(p, tile_pos.data());
+        return h;
+    }
+};
+
+// 目標盤面のセル集合のリストからパターンデータベースを構築する
+inline AdditivePDB build_additive_pdb(const Puzzle& goal,
+                                      const std::string& name,
+                                      std::initializer_list<std::vector<int>> partition) {
+    AdditivePDB pdb;
+    pdb.name = name;
+    uint32_t seen = 0;
+    for (const auto& cells : partition) {
+        for (int c : cells) {
+            if (c < 0 || c > 15 || (seen & (1u << c))) {
+                throw std::invalid_argument("partition cells must be disjoint and in [0, 15]");
+            }
+            seen |= 1u << c;
+        }
+        pdb.patterns.push_back(build_pattern_database(goal, cells));
+    }
+    pdb.index_tiles();
+    return pdb;
+}
+
+// 空白セルを除いた 15 セルを、目標盤面での並び順 (セル番号順) に分割する
+inline std::vector<std::vector<int>> split_goal_cells(const Puzzle& goal, std::initializer_list<int> sizes) {
+    std::vector<int> cells;
+    for (int i = 0; i < 16; ++i) {
+        if (i != goal.zero_pos) cells.push_back(i);
+    }
+    std::vector<std::vector<int>> out;
+    std::size_t at = 0;
+    for (int sz : sizes) {
+        out.emplace_back(cells.begin() + at, cells.begin() + at + sz);
+        at += sz;
+    }
+    return out;
+}
+
+// 7-8 分割: 空白以外のセルを番号順に 7 個 / 8 個に分ける
+// （Korf の目標盤面では上半分 1..7 と下半分 8..15）
+inline AdditivePDB build_pdb_78(const Puzzle& goal = Puzzle::goal()) {
+    auto parts = split_goal_cells(goal, {7, 8});
+    return build_additive_pdb(goal, "pdb78", {parts[0], parts[1]});
+}
+
+// 6-6-3 分割: 空白以外のセルを番号順に 6 個 / 6 個 / 3 個に分ける
+inline AdditivePDB build_pdb_663(const Puzzle& goal = Puzzle::goal()) {
+    auto parts = split_goal_cells(goal, {6, 6, 3});
+    return build_additive_pdb(goal, "pdb663", {parts[0], parts[1], parts[2]});
+}
+
+// 名前から分割を選んで構築する (pdb663 / pdb78)
+inline AdditivePDB build_pdb_by_name(const std::string& name, const Puzzle& goal = Puzzle::goal()) {
+    if (name == "pdb663") return build_pdb_663(goal);
+    if (name == "pdb78")  return build_pdb_78(goal);
+    throw std::invalid_argument("unknown pattern database: " + name);
+}
+
+// IDA* / A* 用の差分評価器
+// タイル位置を保持しておき、動いたタイルが属するパターンだけを引き直す
+struct PdbHeuristic {
+    const AdditivePDB* pdb;
+    std::array<uint8_t, 16> tile_pos{};
+
+    explicit PdbHeuristic(const AdditivePDB& db) : pdb(&db) {}
+
+    inline int reset(const Puzzle& s) noexcept {
+        for (int i = 0; i < 16; ++i) tile_pos[s.get(i)] = static_cast<uint8_t>(i);
+        int h = 0;
+        for (int p = 0; p < static_cast<int>(pdb->patterns.size()); ++p) h += pdb->lookup(p, tile_pos.data());
+        return h;
+    }
+
+    // タイル t が oldPos → newPos へ動いたときの h
+    inline int update(int h, uint8_t t, int oldPos, int newPos) noexcept {
+        const int p = pdb->tile_pattern[t];
+        const int before = pdb->lookup(p, tile_pos.data());
+        tile_pos[t] = static_cast<uint8_t>(newPos);
+        tile_pos[0] = static_cast<uint8_t>(oldPos);
+        return h - before + pdb->lookup(p, tile_pos.data());
+    }
+
+    inline void undo(uint8_t t, int oldPos, int newPos) noexcept {
+        tile_pos[t] = static_cast<uint8_t>(oldPos);
+        tile_pos[0] = static_cast<uint8_t>(newPos);
+    }
+
+    // n 個の盤面をまとめて評価する
+    // 先に全盤面・全パターンの添字を求めてから表を引くので、表（数百 MB）へのランダムアクセスが重なって待ち時間が隠れる。
+    // AVX2 では 8 個ずつ gather で引く（1 バイトの表を 4 バイト単位で読むので、末尾の 3 要素は読む位置を前にずらしてシフトで合わせる）
+    void evaluate_batch(const uint64_t* packed, const uint8_t*, std::size_t n, uint8_t* h) {
+        const int np = static_cast<int>(pdb->patterns.size());
+        ranks.resize(static_cast<std::size_t>(np) * n);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::array<uint8_t, 16> pos_of{};
+            for (int c = 0; c < 16; ++c) pos_of[(packed[i] >> (4 * c)) & 0xF] = static_cast<uint8_t>(c);
+            for (int p = 0; p < np; ++p) {
+                const PatternDatabase& db = pdb->patterns[p];
+                std::array<uint8_t, 8> pos{};
+                for (int k = 0; k < db.size(); ++k) pos[k] = pos_of[db.tiles[k]];
+                ranks[p * n + i] = pattern_rank(pos.data(), db.size());
+            }
+            h[i] = 0;
+        }
+        for (int p = 0; p < np; ++p) {
+            const PatternDatabase& db = pdb->patterns[p];
+            const uint32_t* r = ranks.data() + p * n;
+            std::size_t i = 0;
+#if defined(__AVX2__)
+            if (db.entries >= 4) {
+                const __m256i last = _mm256_set1_epi32(static_cast<int>(db.entries - 4));
+                const __m256i low8 = _mm256_set1_epi32(0xFF);
+                alignas(32) uint32_t v[8];
+                for (; i + 8 <= n; i += 8) {
+                    const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + i));
+                    const __m256i at = _mm256_min_epu32(idx, last);
+                    const __m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(idx, at), 3);
+                    const __m256i word = _mm256_i32gather_epi32(reinterpret_cast<const int*>(db.dist), at, 1);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(v), _mm256_and_si256(_mm256_srlv_epi32(word, shift), low8));
+                    for (int k = 0; k < 8; ++k) h[i + k] = static_cast<uint8_t>(h[i + k] + v[k]);
+                }
+            }
+#endif
+            for (; i < n; ++i) h[i] = static_cast<uint8_t>(h[i] + db.dist[r[i]]);
+        }
+    }
+
+    std::vector<uint32_t> ranks; // evaluate_batch の作業領域 [パターン][盤面]
+};
+
+} // namespace puzzle15
@@ -0,0 +1,300 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <variant>
+#include <utility>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "puzzle15.hpp"
+#include "heuristic15.hpp"
+#include "pdb15.hpp"
+
+// パターンデータベースのファイル保存と mmap による読み込み
+//
+// ファイル形式 (リトルエンディアン, バージョン 1)
+//   [0, 4096)  : PdbFileHeader（残りは 0 埋め）
+//   以降       : 各パターンのテーブル (1 要素 1 バイト)。先頭はそれぞれ 4096 バイト境界に揃える
+//
+// 一度書き出したファイルは読み取り専用で mmap するので、同じマシン上の複数の
+// ソルバープロセスがページキャッシュを共有し、起動はヘッダ検証だけで済む。
+
+namespace puzzle15 {
+
+constexpr char     PDB_FILE_MAGIC[8]    = {'P', 'D', 'B', '1', '5', '\0', '\0', '\0'};
+constexpr uint32_t PDB_FILE_VERSION     = 1;
+constexpr uint32_t PDB_FILE_MAX_PATTERNS = 4;
+constexpr uint64_t PDB_FILE_ALIGN       = 4096;
+
+struct PdbFilePattern {
+    uint8_t  k;         // パターンのタイル数
+    uint8_t  tiles[8];  // パターンのタイル（k 個以降は 0）
+    uint8_t  reserved[7];
+    uint64_t offset;    // ファイル先頭からのテーブル位置
+    uint64_t entries;   // テーブルの要素数
+};
+
+struct PdbFileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t num_patterns;
+    char     name[16];     // 分割の名前 (pdb663 / pdb78)
+    uint64_t goal_packed;  // 目標盤面
+    uint8_t  goal_zero;
+    uint8_t  reserved[7];
+    uint64_t checksum;     // 全テーブルのチェックサム
+    PdbFilePattern patterns[PDB_FILE_MAX_PATTERNS];
+};
+static_assert(sizeof(PdbFileHeader) <= PDB_FILE_ALIGN, "header must fit in the first page");
+
+// テーブルのチェックサム（8 バイト単位の FNV-1a 変種）
+inline uint64_t pdb_checksum(uint64_t h, const uint8_t* data, uint64_t n) noexcept {
+    constexpr uint64_t PRIME = 0x100000001b3ULL;
+    uint64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h = (h ^ w) * PRIME;
+    }
+    for (; i < n; ++i) h = (h ^ data[i]) * PRIME;
+    return h;
+}
+
+inline uint64_t pdb_checksum(const AdditivePDB& pdb) noexcept {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const auto& db : pdb.patterns) h = pdb_checksum(h, db.dist, db.entries);
+    return h;
+}
+
+inline uint64_t align_up(uint64_t x, uint64_t a) noexcept { return (x + a - 1) / a * a; }
+
+// 目標盤面と名前からファイル名を決める（例: pdb663-fedcba9876543210.pdb）
+inline std::string pdb_file_path(const std::string& dir, const std::string& name, const Puzzle& goal) {
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(goal.packed));
+    return dir + "/" + name + "-" + hex + ".pdb";
+}
+
+// ファイルへ書き出す。一時ファイルに書いてから rename するので、
+// 並行して起動した他プロセスが書きかけのファイルを開くことはない。
+inline void write_pdb_file(const std::string& path, const AdditivePDB& pdb, const Puzzle& goal) {
+    if (pdb.patterns.size() > PDB_FILE_MAX_PATTERNS || pdb.name.size() >= sizeof(PdbFileHeader::name)) {
+        throw std::invalid_argument("pattern database does not fit in the file header");
+    }
+
+    PdbFileHeader hdr;
+    std::memset(&hdr, 0, sizeof(hdr));
+    std::memcpy(hdr.magic, PDB_FILE_MAGIC, sizeof(hdr.magic));
+    hdr.version = PDB_FILE_VERSION;
+    hdr.num_patterns = static_cast<uint32_t>(pdb.patterns.size());
+    std::memcpy(hdr.name, pdb.name.data(), pdb.name.size());
+    hdr.goal_packed = goal.packed;
+    hdr.goal_zero = goal.zero_pos;
+    hdr.checksum = pdb_checksum(pdb);
+
+    uint64_t offset = PDB_FILE_ALIGN;
+    for (std::size_t p = 0; p < pdb.patterns.size(); ++p) {
+        const auto& db = pdb.patterns[p];
+        hdr.patterns[p].k = static_cast<uint8_t>(db.size());
+        for (int i = 0; i < db.size(); ++i) hdr.patterns[p].tiles[i] = db.tiles[i];
+        hdr.patterns[p].offset = offset;
+        hdr.patterns[p].entries = db.entries;
+        offset = align_up(offset + db.entries, PDB_FILE_ALIGN);
+    }
+
+    const std::string tmp = path + ".tmp." + std::to_string(::getpid());
+    std::FILE* fp = std::fopen(tmp.c_str(), "wb");
+    if (!fp) throw std::runtime_error("Failed to create " + tmp);
+
+    auto write_at = [&](uint64_t pos, const void* data, uint64_t n) {
+        if (std::fseek(fp, static_cast<long>(pos), SEEK_SET) != 0 || std::fwrite(data, 1, n, fp) != n) {
+            std::fclose(fp);
+            std::remove(tmp.c_str());
+            throw std::runtime_error("Failed to write " + tmp);
+        }
+    };
+
+    write_at(0, &hdr, sizeof(hdr));
+    for (std::size_t p = 0; p < pdb.patterns.size(); ++p) {
+        write_at(hdr.patterns[p].offset, pdb.patterns[p].dist, pdb.patterns[p].entries);
+    }
+    // 末尾のパディングも含めてファイル長を確定させる
+    const uint8_t zero = 0;
+    write_at(offset - 1, &zero, 1);
+
+    if (std::fclose(fp) != 0 || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        throw std::runtime_error("Failed to finalize " + path);
+    }
+}
+
+// mmap したファイルの寿命を管理する
+struct MappedFile {
+    void* addr = MAP_FAILED;
+    std::size_t length = 0;
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() {
+        if (addr != MAP_FAILED) ::munmap(addr, length);
+    }
+
+    const uint8_t* data() const noexcept { return static_cast<const uint8_t*>(addr); }
+};
+
+// ファイルを読み取り専用で mmap してパターンデータベースとして開く
+// 失敗したら std::nullopt（ファイルが無い・壊れている・目標盤面が違う）
+// verify_checksum = true のときはテーブル全体を読んでチェックサムも確認する（起動は遅くなる）
+inline std::optional<AdditivePDB> open_pdb_file(const std::string& path,
+                                                const std::string& name,
+                                                const Puzzle& goal,
+                                                bool verify_checksum = false) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return std::nullopt;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < PDB_FILE_ALIGN) {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    auto map = std::make_shared<MappedFile>();
+    map->length = static_cast<std::size_t>(st.st_size);
+    map->addr = ::mmap(nullptr, map->length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // mmap 後は fd を閉じてもよい
+    if (map->addr == MAP_FAILED) return std::nullopt;
+
+    PdbFileHeader hdr;
+    std::memcpy(&hdr, map->data(), sizeof(hdr));
+    if (std::memcmp(hdr.magic, PDB_FILE_MAGIC, sizeof(hdr.magic)) != 0
+        || hdr.version != PDB_FILE_VERSION
+        || hdr.num_patterns == 0 || hdr.num_patterns > PDB_FILE_MAX_PATTERNS
+        || std::strncmp(hdr.name, name.c_str(), sizeof(hdr.name)) != 0
+        || hdr.goal_packed != goal.packed || hdr.goal_zero != goal.zero_pos) {
+        return std::nullopt;
+    }
+
+    AdditivePDB pdb;
+    pdb.name = name;
+    uint32_t seen = 0;
+    for (uint32_t p = 0; p < hdr.num_patterns; ++p) {
+        const PdbFilePattern& fp = hdr.patterns[p];
+        if (fp.k == 0 || fp.k > 8 || fp.entries != pattern_size(fp.k)
+            || fp.offset % PDB_FILE_ALIGN != 0 || fp.offset + fp.entries > map->length) {
+            return std::nullopt;
+        }
+        PatternDatabase db;
+        for (int i = 0; i < fp.k; ++i) {
+            const uint8_t t = fp.tiles[i];
+            if (t == 0 || t > 15 || (seen & (1u << t))) return std::nullopt;
+            seen |= 1u << t;
+            db.tiles.push_back(t);
+        }
+        db.dist = map->data() + fp.offset;
+        db.entries = fp.entries;
+        db.storage = map;
+        pdb.patterns.push_back(std::move(db));
+    }
+    pdb.index_tiles();
+
+    if (verify_checksum && pdb_checksum(pdb) != hdr.checksum) return std::nullopt;
+
+    // 探索中のアクセスはランダムなので先読みは要らないが、バックグラウンドで載せておく
+    ::madvise(map->addr, map->length, MADV_WILLNEED);
+    return pdb;
+}
+
+// ファイルがあれば mmap で開き、無ければ構築して書き出してから開き直す
+inline AdditivePDB load_or_build_pdb(const std::string& name,
+                                     const Puzzle& goal,
+                                     const std::string& dir = ".") {
+    const std::string path = pdb_file_path(dir, name, goal);
+    if (auto pdb = open_pdb_file(path, name, goal)) return std::move(*pdb);
+
+    AdditivePDB built = build_pdb_by_name(name, goal);
+    try {
+        write_pdb_file(path, built, goal);
+    } catch (const std::runtime_error&) {
+        return built; // 書き込めない環境では構築したものをそのまま使う
+    }
+    if (auto pdb = open_pdb_file(path, name, goal, /*verify_checksum=*/true)) return std::move(*pdb);
+    return built;
+}
+
+// 名前で指定されたヒューリスティックを初期化する（init_manhattan_table と同じく起動時に一度呼ぶ）
+// "manhattan" ならマンハッタン表、"linear" なら線形衝突表も、"wd" なら Walking Distance 表も作る。
+// "pdb663" / "pdb78" なら PDB ファイルを開いて PDB に置く
+inline AdditivePDB PDB;
+
+inline void init_heuristic(const std::string& name, const Puzzle& goal, const std::string& dir = ".") {
+    init_manhattan_table(goal);
+    if (name == "manhattan") return;
+    if (name == "linear") {
+        init_linear_conflict_table(goal);
+        return;
+    }
+    if (name == "wd") {
+        init_walking_distance_table(goal);
+        return;
+    }
+    PDB = load_or_build_pdb(name, goal, dir);
+}
+
+// 名前 → 差分評価器の対応表（init_heuristic で表を作ってから使う）
+// 評価器は std::variant の型の 1 つとして作るので、with_heuristic に渡した探索器は評価器ごとに実体化され、
+// 評価値の計算は探索ループにインライン展開される（実行時の分岐は std::visit の 1 回だけ）
+using AnyHeuristic = std::variant<ManhattanHeuristic, LinearConflictHeuristic, WalkingDistanceHeuristic, PdbHeuristic>;
+
+struct HeuristicEntry {
+    const char* name;
+    AnyHeuristic (*make)();
+};
+
+inline const std::array<HeuristicEntry, 5> HEURISTICS = {{
+    {"manhattan", [] { return AnyHeuristic{ManhattanHeuristic{}}; }},
+    {"linear",    [] { return AnyHeuristic{LinearConflictHeuristic{}}; }},
+    {"wd",        [] { return AnyHeuristic{WalkingDistanceHeuristic{}}; }},
+    {"pdb663",    [] { return AnyHeuristic{PdbHeuristic(PDB)}; }},
+    {"pdb78",     [] { return AnyHeuristic{PdbHeuristic(PDB)}; }},
+}};
+
+// 表の中から名前で探す（無ければ nullptr）
+inline const HeuristicEntry* find_heuristic(const std::string& name) noexcept {
+    for (const auto& e : HEURISTICS) {
+        if (name == e.name) return &e;
+    }
+    return nullptr;
+}
+
+// 使える名前の一覧（"manhattan / linear / ..."、使い方の表示用）
+inline std::string heuristic_names() {
+    std::string s;
+    for (const auto& e : HEURISTICS) {
+        if (!s.empty()) s += " / ";
+        s += e.name;
+    }
+    return s;
+}
+
+inline AnyHeuristic make_heuristic(const std::string& name) {
+    const HeuristicEntry* e = find_heuristic(name);
+    if (!e) throw std::invalid_argument("unknown heuristic: " + name);
+    return e->make();
+}
+
+// 名前で選んだ評価器を f に渡して呼ぶ（f は評価器の型ごとに実体化されるジェネリックラムダなど）
+template <class F>
+inline decltype(auto) with_heuristic(const std::string& name, F&& f) {
+    return std::visit(std::forward<F>(f), make_heuristic(name));
+}
+
+} // namespace puzzle15
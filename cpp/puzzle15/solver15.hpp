@@ -1,142 +1,166 @@
 #pragma once
 #include <queue>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
-#include <functional>
 #include <optional>
 #include <algorithm>
 #include <chrono>
 #include <sstream>
 #include "puzzle15.hpp"
 #include "heuristic15.hpp"
+#include "pdb15.hpp"
 #include "bucket_pq.hpp"
+#include "../sliding/flat_table.hpp"
+#include "../sliding/move_pruning.hpp"
+#include "../sliding/transposition_table.hpp"
+#include "../sliding/search_stats.hpp"
+#include "../sliding/solvability.hpp"
 
 namespace solver15 {
-    static inline puzzle15::Puzzle::Move inverse_move(puzzle15::Puzzle::Move m) noexcept {
-    using M = puzzle15::Puzzle::Move;
-    switch (m) {
-        case M::Up:    return M::Down;
-        case M::Down:  return M::Up;
-        case M::Left:  return M::Right;
-        case M::Right: return M::Left;
-    }
-    return M::Up; // 到達不能
-}
+using sliding::inverse_move; // 方向の反転（全盤面サイズ共通）
 
 struct SearchResult { // 探索結果用の構造体
     std::optional<std::vector<puzzle15::Puzzle::Move>> path;
     std::size_t generated = 0;
     long long elapsed_ms = 0;
+    std::vector<std::size_t> generated_per_thread; // 並列探索でのスレッドごとの生成ノード数（逐次探索では空）
+    std::size_t stored = 0; // 探索の終わりに状態表に残っていた盤面の数（A*, 双方向探索。メモリ使用量の目安）
+    sliding::SearchStats stats; // 探索の内訳（A*, IDA*。SLIDING_SEARCH_STATS を有効にしたときだけ書く）
+    bool unsolvable = false; // start から goal へ行けない（偶奇が違うので探索せずに返した。path は空）
+    int initial_bound = -1; // IDA* の最初の閾値 = h(start)（IDA* 以外は -1）
 };
 
-using Heuristic = std::function<int(const puzzle15::Puzzle&)>; // ヒューリスティック関数の型
+// 行けない問題への結果
+// どの探索器も入口で sliding::is_solvable を見て、偶奇が違えばこれを返す
+// （調べずに探索すると、IDA* は閾値を上げ続けて止まらず、A* は到達できる半分の状態空間を使い切るまで止まらない）
+inline SearchResult unsolvable_result() {
+    SearchResult out;
+    out.unsolvable = true;
+    return out;
+}
+
+// A* の作業領域（オープンリストと状態表）
+// 何問も続けて解くときは 1 つ作って A_star_path に渡せば、2 問目からは確保もページフォールトもほとんど起きない。
+// reset() は中身を消すだけで、確保した領域は残す（スレッドごとに 1 つ持つ）
+template <class P = puzzle15::Puzzle, TieBreak Tie = TieBreak::Fifo>
+struct SearchContext {
+    static constexpr int MAX_DEPTH = P::Geometry::MAX_DEPTH;
+    static_assert(MAX_DEPTH + 1 <= 255, "g and h are stored as uint8_t in FlatStateTable");
+
+    // オープンリストには盤面だけを積む（f, h はバケットの位置からわかる） // max値の設定は最重要
+    BucketPriorityQueue<P, Tie, true> open{0, MAX_DEPTH + 2, 0, MAX_DEPTH + 2};
+    // g, h, closed, 親からの手を 1 スロットに集約（足りなければ伸びる）
+    sliding::FlatStateTable<typename P::Storage> table{1 << 20};
+
+    void reset() noexcept {
+        open.clear();
+        table.clear();
+    }
+};
 
 // A* Search 
+// H は reset / update / undo を持つ差分評価器（ManhattanHeuristic, PdbHeuristic など）
+// P は sliding::SlidingPuzzle<R, C>（既定は 15パズル）。24パズルなども同じエンジンで解ける
+// Tie は同じ (f,h) の中の順序（bucket_pq.hpp の TieBreak）
+// ctx の中身は最初に消す（前の問題の結果は残らない）
+template <class H = puzzle15::ManhattanHeuristic, class P = puzzle15::Puzzle, TieBreak Tie = TieBreak::Fifo>
 inline SearchResult
-A_star_path(const puzzle15::Puzzle& start,
-            const puzzle15::Puzzle& goal
+A_star_path(SearchContext<P, Tie>& ctx,
+            const P& start,
+            const P& goal,
+            H heur = H{}
             ) {
-    using puzzle15::Puzzle;
-    Heuristic h = puzzle15::manhattan_heuristic_fast;
+    static_assert(sliding::is_incremental_heuristic_v<H, P>, "H must provide reset / update / undo");
+    using Puzzle = P;
+    using Move = sliding::Move;
+    if (!sliding::is_solvable(start, goal)) return unsolvable_result();
 
     auto t0 = std::chrono::steady_clock::now();
     std::size_t generated = 0;
-
-    struct Node {
-        int f; // プライオリティ値
-        int g; // 実コスト（手数）
-        int h; // ヒューリスティック値
-        Puzzle s; // 現在の状態
-    };
-
-    struct Cmp { // 比較関数
-        bool operator()(const Node& a, const Node& b) const noexcept {
-            if (a.f != b.f) return a.f > b.f; // fが異なるならfが小さい方が優先
-            return a.h > b.h; // 同点ならhが小さい方を優先
-        }
-    };
-
-    
+    sliding::SearchStats stats;
 
     if (start.packed == goal.packed) { // もし開始状態が目標状態なら
         auto t1 = std::chrono::steady_clock::now();
         return SearchResult{
-            std::make_optional(std::vector<Puzzle::Move>{}),
+            std::make_optional(std::vector<Move>{}),
             generated,
             std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()
         };
     }
 
-    using Key = uint64_t;
-
-    struct  Parent{
-        Key prev;
-        puzzle15::Puzzle::Move move;
-        uint8_t prev_zero;
+    ctx.reset();
+    auto& open = ctx.open;
+    auto& table = ctx.table;
+    // 第二キー: 通常は h、HighG のときは g
+    auto second_key = [](int g, int h) { return Tie == TieBreak::HighG ? g : h; };
+    // 探索の終わりの状態表の様子を stats に書く
+    auto finish_stats = [&] {
+        if constexpr (sliding::SEARCH_STATS_ENABLED) {
+            stats.table_size = table.size();
+            stats.table_capacity = table.capacity();
+            stats.table_probes = table.probe_stats().probes;
+            stats.table_probe_steps = table.probe_stats().steps;
+            stats.table_probe_max = table.probe_stats().max;
+        }
+        return std::move(stats);
     };
 
-    BucketPriorityQueue<Node> open(0, 82, 0, 80); // オープンリストのデータ構造 // max値の設定は最重要
-    struct Meta { int g; int h; bool closed; };
-    std::unordered_map<Key, Meta> meta; // g,h,closed を集約
-    std::unordered_map<Key, Parent> parent; // <子状態, (親状態, 打った手)>
-
-    meta.reserve(1 << 24);
-    parent.reserve(1 << 24);
-
-
-    int hstart = h(start);
-    open.push(Node{hstart, 0, hstart, start}, hstart, hstart);
-    meta[start.packed] = {0, hstart, false};
+    int hstart = sliding::timed_heuristic(stats, [&] { return heur.reset(start); });
+    open.push(start, hstart, second_key(0, hstart));
+    {
+        auto& root = *table.insert(start.packed).first;
+        root.g = 0;
+        root.h = static_cast<uint8_t>(hstart);
+    }
 
-    constexpr Puzzle::Move MOVES[4] = {
-        Puzzle::Move::Up, Puzzle::Move::Down, Puzzle::Move::Left, Puzzle::Move::Right
+    constexpr Move MOVES[4] = {
+        Move::Up, Move::Down, Move::Left, Move::Right
     };
 
-    std::optional<Puzzle::Move> prev_move = std::nullopt;
-
     while (!open.empty()) {
-        Node cur = open.top(); // オープンリストから最小のノードを取得
+        Puzzle s = open.top(); // オープンリストから最小のノードを取得
+        const int f_cur = open.top_f();
+        const int g_cur = (Tie == TieBreak::HighG) ? open.top_h() : f_cur - open.top_h();
         open.pop(); // オープンリストからノードを削除
 
-        
-        auto itp = parent.find(cur.s.packed);
-        if (itp != parent.end()) {
-            prev_move = itp->second.move;
-        }
-
-        puzzle15::Puzzle s = cur.s;
-
         // ゴール条件を満たした場合
-        if (cur.s.packed == goal.packed) {
-            std::vector<Puzzle::Move> path;
-            Puzzle x = cur.s;
+        if (s.packed == goal.packed) {
+            // 親の盤面は子の盤面で手を戻して得る
+            std::vector<Move> path;
+            path.reserve(g_cur); // 結果の経路は 1 回の確保で済ませる
+            Puzzle x = s;
             while (!(x.packed == start.packed)) {
-                auto itp = parent.find(x.packed);
-                if (itp == parent.end()) break; // ありえないが念のため
-                path.push_back(itp->second.move);
-
-                puzzle15::Puzzle prev;
-                prev.packed = itp->second.prev;
-                prev.zero_pos = itp->second.prev_zero;
-                x = prev;
+                const auto* slot = table.find(x.packed);
+                if (!slot || !slot->move()) break; // ありえないが念のため
+                path.push_back(*slot->move());
+                x.undo_move_inplace(x.get(slot->prev_zero), slot->prev_zero);
             }
             std::reverse(path.begin(), path.end()); // スタートからゴールへの経路にする
             auto t1 = std::chrono::steady_clock::now();
             return SearchResult{
                 std::make_optional(std::move(path)),
                 generated,
-                std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()
+                std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count(),
+                {},
+                table.size(),
+                finish_stats()
             };
         }
 
         // クローズドリストへの追加
         // 遅延重複検出
+        std::optional<Move> prev_move;
         {
-            Meta &m = meta[s.packed];
-            if (m.closed) continue; // すでにクローズドリストにあるならスキップ
-            m.closed = true; // クローズドリストに追加
+            auto* slot = table.find(s.packed);
+            if (slot->closed()) { // すでにクローズドリストにあるならスキップ
+                if constexpr (sliding::SEARCH_STATS_ENABLED) ++stats.duplicates;
+                continue;
+            }
+            slot->set_closed(); // クローズドリストに追加
+            prev_move = slot->move();
         }
+        if constexpr (sliding::SEARCH_STATS_ENABLED) ++stats.expanded;
+
+        const int h_parent = sliding::timed_heuristic(stats, [&] { return heur.reset(s); }); // 差分評価器を親の盤面に合わせる
 
         
 
@@ -156,24 +180,32 @@ A_star_path(const puzzle15::Puzzle& start,
             }
 
             const int new_zero = s.zero_pos;
-            const int h_parent = meta.at(cur.s.packed).h;
-            const int h_child = puzzle15::manhattan_delta_for_move(h_parent, moved_tile, new_zero, old_zero);
-            const int g_child = cur.g + 1; // 子ノードのg値
+            const int h_child = sliding::timed_heuristic(stats, [&] {
+                return heur.update(h_parent, moved_tile, new_zero, old_zero);
+            });
+            const int g_child = g_cur + 1; // 子ノードのg値
             const int f_child = g_child + h_child;
-            const Key key = s.packed;
+            if constexpr (sliding::SEARCH_STATS_ENABLED) ++stats.generated;
 
-            auto it = meta.find(key);
-            if (it != meta.end() && g_child >= it->second.g) {
+            auto [slot, inserted] = table.insert(s.packed);
+            if (!inserted && g_child >= slot->g) {
+                if constexpr (sliding::SEARCH_STATS_ENABLED) ++stats.duplicates;
+                heur.undo(moved_tile, new_zero, old_zero);
                 s.undo_move_inplace(moved_tile, old_zero);
                 continue;
             }
-
-            parent[key] = {cur.s.packed, m, static_cast<uint8_t>(old_zero)};
-            meta[key] = {g_child, h_child, false};
+            if constexpr (sliding::SEARCH_STATS_ENABLED) {
+                if (!inserted && slot->closed()) ++stats.reopened;
+            }
+            slot->assign(g_child, h_child, m, old_zero);
 
             generated++; // 生成ノード数をカウント
-            open.push(Node{f_child, g_child, h_child, s}, f_child, h_child);
+            open.push(s, f_child, second_key(g_child, h_child));
+            if constexpr (sliding::SEARCH_STATS_ENABLED) {
+                if (open.size() > stats.open_max) stats.open_max = open.size();
+            }
 
+            heur.undo(moved_tile, new_zero, old_zero);
             s.undo_move_inplace(moved_tile, old_zero); // 元の状態に戻す
         }
     }
@@ -181,128 +213,194 @@ A_star_path(const puzzle15::Puzzle& start,
     return SearchResult{
         std::nullopt,
         generated,
-        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count()
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count(),
+        {},
+        table.size(),
+        finish_stats()
     };
 }
 
+// 1 問だけ解くとき（作業領域をその場で作る）
+template <class H = puzzle15::ManhattanHeuristic, class P = puzzle15::Puzzle, TieBreak Tie = TieBreak::Fifo>
+inline SearchResult
+A_star_path(const P& start,
+            const P& goal,
+            H heur = H{}
+            ) {
+    SearchContext<P, Tie> ctx;
+    return A_star_path<H, P, Tie>(ctx, start, goal, heur);
+}
+
+// IDA* Search
+// tt_mb > 0 なら、その大きさ（MB）の置換表で同じ反復の中で再び到達した盤面を枝刈りする（0 なら使わない）
+template <class H = puzzle15::ManhattanHeuristic, class P = puzzle15::Puzzle>
 inline SearchResult
-IDA_star_path(const puzzle15::Puzzle& start,
-              const puzzle15::Puzzle& goal) {
-    using puzzle15::Puzzle;
+IDA_star_path(const P& start,
+              const P& goal,
+              H heur = H{},
+              std::size_t tt_mb = 0) {
+    static_assert(sliding::is_incremental_heuristic_v<H, P>, "H must provide reset / update / undo");
+    using Puzzle = P;
+    using Move = sliding::Move;
+    using Key = typename P::Storage;
+    constexpr int MAX_DEPTH = P::Geometry::MAX_DEPTH;
+    // 置換表を引くのは f が閾値より TT_MIN_SLACK 以上小さい子だけ（f == bound の子は部分木が小さく、引く方が高くつく）
+    constexpr int TT_MIN_SLACK = 2;
+    if (!sliding::is_solvable(start, goal)) return unsolvable_result();
+
+    // 直前手の巻き戻しや短い閉路などの重複経路はオートマトンで枝刈りする（経路上の盤面の集合は持たない）
+    // 構築は盤面サイズごとに最初の 1 回だけなので、探索時間には含めない
+    const auto& fsm = sliding::MovePruningFsm<P::ROWS, P::COLS>::instance();
+
+    // 置換表（確保も探索時間に含めない）
+    std::optional<sliding::TranspositionTable<Key>> tt;
+    if (tt_mb > 0) tt.emplace(tt_mb);
 
     SearchResult out;
     auto t0 = std::chrono::steady_clock::now();
 
     // 与えられたスタート状態がゴール状態なら
     if (start.packed == goal.packed) {
-        out.path = std::vector<Puzzle::Move>{}; // 空経路
+        out.path = std::vector<Move>{}; // 空経路
         out.generated = 1;
         auto t1 = std::chrono::steady_clock::now();
         out.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
         return out;
     }
 
-    // IDA* 用ワーキング領域
-    std::array<Puzzle::Move, 81> path; // 探索経路
-    std::array<uint64_t, 81> onpath; // ループ防止用、最大の深さは 80 なので 81 で十分
-    int depth = 0;
-    std::unordered_set<uint64_t> onpath_set; // ループ防止用セット
-    onpath_set.reserve(81); // 81個の状態を保存するためのセット
+    // IDA* 用ワーキング領域（再帰の代わりに明示的なスタックで深さ優先探索する）
+    // フレーム d は深さ d の節点: 次に試す手の番号, h, オートマトンの状態, f 超過の最小値,
+    // そこへ来た手を戻すための情報（動かしたタイル・親での空白の位置）
+    struct Frame {
+        int h;
+        int fsm_state;
+        int min_next;
+        uint8_t next;       // Geometry::SUCCESSORS[空白の位置] の中で次に試す位置
+        uint8_t moved_tile;
+        uint8_t old_zero;
+    };
+    std::array<Frame, MAX_DEPTH + 2> stack;
+    std::array<Move, MAX_DEPTH + 1> path; // 探索経路、15パズルの最大の深さは 80 なので 81 で十分
+    sliding::TranspositionTable<Key>* table = tt ? &*tt : nullptr;
 
-    const int h0 = puzzle15::manhattan_heuristic_fast(start);
+    const int h0 = sliding::timed_heuristic(out.stats, [&] { return heur.reset(start); });
     int bound = h0; // 初期の閾値
+    out.initial_bound = bound;
 
-    std::cout << "Initial bound: " << bound << "\n";
-
-    // 再帰DFS: 見つかったら負値（-1）を返す。見つからなければ次の閾値候補（最小の f 超過値）
-    struct Dfs {
-        const Puzzle& goal;
-        SearchResult& out;
-        std::array<uint64_t, 81>& onpath;
-        std::array<Puzzle::Move, 81>& path;
-        int& depth;
-        std::unordered_set<uint64_t>& onpath_set;
-
-
-        int operator()(Puzzle& s, int g, int bound, int h, std::optional<Puzzle::Move> prev_move) { // s を書き換えて探索する
-            const int f = g + h;
-            if (f > bound) return f;                    // 閾値超過 → 次のbound候補
-            if (s.packed == goal.packed) return -1;     // 発見
-
-            // 展開（子の f 超過の最小値を覚える）
-            int min_next = std::numeric_limits<int>::max();
-
-            static constexpr Puzzle::Move MOVES[4] = {
-                Puzzle::Move::Up, Puzzle::Move::Down, Puzzle::Move::Left, Puzzle::Move::Right
-            };
+    constexpr int NOT_FOUND = std::numeric_limits<int>::max();
 
-            for (Puzzle::Move mv : MOVES) {
-                if (prev_move.has_value() && mv == inverse_move(*prev_move)) {
-                    continue; // 即時バックトラック防止
-                }
+    // 閾値 bound で 1 反復。見つかったら -1（経路は path[0, depth)）、見つからなければ次の閾値候補
+    int depth = 0;
+    auto iterate = [&](int bound) -> int {
+        Puzzle s = start;
+        depth = 0;
+        stack[0] = Frame{h0, fsm.START, NOT_FOUND, 0, 0, 0};
+        std::size_t generated = 0;
+        // この反復の内訳（計測が無効なら使わない）
+        sliding::IterationStats it;
+        std::chrono::steady_clock::time_point it_t0;
+        auto finish_iteration = [&] {
+            if constexpr (sliding::SEARCH_STATS_ENABLED) {
+                it.bound = bound;
+                it.generated = generated;
+                it.elapsed_ns =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - it_t0).count();
+                out.stats.expanded += it.expanded;
+                out.stats.generated += it.generated;
+                out.stats.iterations.push_back(it);
+            }
+        };
+        if constexpr (sliding::SEARCH_STATS_ENABLED) {
+            it_t0 = std::chrono::steady_clock::now();
+            it.expanded = 1; // 根
+        }
 
-                uint8_t moved_tile = 0, old_zero = 0;
-                if (!s.apply_move_inplace(mv, moved_tile, old_zero)) {
-                    continue; // 移動できない場合はスキップ
-                }
+        for (;;) {
+            Frame& fr = stack[depth];
+            const auto& succ = P::Geometry::SUCCESSORS[s.zero_pos];
 
-                if (onpath_set.count(s.packed)) { // ループ検出
-                    s.undo_move_inplace(moved_tile, old_zero);
-                    continue;
+            if (fr.next == succ.count) { // この節点の子をすべて試した → 親へ戻る
+                if (depth == 0) {
+                    out.generated += generated;
+                    finish_iteration();
+                    return fr.min_next;
                 }
-
+                const int r = fr.min_next;
                 const int new_zero = s.zero_pos;
-                const int h_child = puzzle15::manhattan_delta_for_move(h, moved_tile, new_zero, old_zero);
-                const int f_child = (g + 1) + h_child;
+                heur.undo(fr.moved_tile, new_zero, fr.old_zero);
+                s.unslide_blank(fr.moved_tile, fr.old_zero);
+                --depth;
+                if (r < stack[depth].min_next) stack[depth].min_next = r;
+                continue;
+            }
 
-                ++out.generated; // 生成ノード数をカウント
+            const int k = fr.next++;
+            const Move mv = succ.move[k];
+            const int next_state = fsm.next(fr.fsm_state, mv);
+            if (next_state < 0) {
+                if constexpr (sliding::SEARCH_STATS_ENABLED) ++out.stats.duplicates;
+                continue; // 重複経路（即時バックトラックを含む）の枝刈り
+            }
 
-                if (f_child > bound) {
-                    if (f_child < min_next) {
-                        min_next = f_child; // 最小の f 超過値を更新
-                    }
-                    s.undo_move_inplace(moved_tile, old_zero); // 元に戻す
-                    continue;
-                }
+            // 子の評価値は盤面を書き換える前に求める（閾値を超える子がほとんどなので、書き換えと戻しを省く）
+            const int old_zero = s.zero_pos;
+            const int new_zero = succ.to[k];
+            const uint8_t moved_tile = s.get(new_zero);
+            if (table) { // 評価値の計算と並行して置換表を読み込む
+                Key child = s.packed;
+                P::Policy::slide(child, new_zero, old_zero, moved_tile);
+                table->prefetch(child);
+            }
 
-                path[depth] = mv;
-                onpath[depth] = s.packed; // 現在の状態を保存
-                onpath_set.insert(s.packed); // ループ防止用セットに追加
-                ++depth;
+            const int g_child = depth + 1;
+            const int h_child = sliding::timed_heuristic(out.stats, [&] {
+                return heur.update(fr.h, moved_tile, new_zero, old_zero);
+            });
+            const int f_child = g_child + h_child;
 
-                int r = (*this)(s, g + 1, bound, h_child, mv);
-                if (r == -1) return -1;
-                if (r < min_next) min_next = r;
+            ++generated; // 生成ノード数をカウント
 
-                --depth; // 深さを戻す
-                onpath_set.erase(s.packed); // ループ防止用セットから削除
-                s.undo_move_inplace(moved_tile, old_zero); // 元に戻す
+            if (f_child > bound) {
+                if (f_child < fr.min_next) {
+                    fr.min_next = f_child; // 最小の f 超過値を更新
+                }
+                heur.undo(moved_tile, new_zero, old_zero);
+                continue;
             }
+            s.slide_blank(new_zero);
 
-            return (min_next == std::numeric_limits<int>::max()) ? std::numeric_limits<int>::max() : min_next;
-    }
-};
-
+            // この反復で同じ盤面に、より浅く（または同じ深さ・同じ状態で）到達済みなら部分木は探索済み
+            if (table && bound - f_child >= TT_MIN_SLACK && table->probe_and_store(s.packed, g_child, next_state)) {
+                if constexpr (sliding::SEARCH_STATS_ENABLED) ++out.stats.duplicates;
+                heur.undo(moved_tile, new_zero, old_zero);
+                s.unslide_blank(moved_tile, old_zero); // 元に戻す
+                continue;
+            }
 
+            path[depth] = mv;
+            ++depth;
+            if (s.packed == goal.packed) { // 発見
+                out.generated += generated;
+                finish_iteration();
+                return -1;
+            }
+            if constexpr (sliding::SEARCH_STATS_ENABLED) ++it.expanded;
+            stack[depth] = Frame{h_child, next_state, NOT_FOUND, 0, moved_tile, static_cast<uint8_t>(old_zero)};
+        }
+    };
 
     // 実際のIDA*探索
     for (;;) {
-        depth = 0;
-        onpath[0] = start.packed;
-        onpath_set.clear();
-        onpath_set.insert(start.packed); // スタート状態をセットに追加
-
-        Dfs dfs{goal, out, onpath, path, depth, onpath_set};
+        if (tt) tt->new_iteration();
 
-        Puzzle cur = start; // 現在の状態を保持
-        int r = dfs(cur, 0, bound, h0, std::nullopt);
+        int r = iterate(bound);
         if (r == -1) {
-            out.path = std::vector<Puzzle::Move>(path.begin(), path.begin() + depth);
+            out.path = std::vector<Move>(path.begin(), path.begin() + depth);
             auto t1 = std::chrono::steady_clock::now();
             out.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
             return out;
         }
-        if (r == std::numeric_limits<int>::max()) { // すべての子が閾値超過なら終了
+        if (r == NOT_FOUND) { // すべての子が閾値超過なら終了
             out.path = std::nullopt;
             auto t1 = std::chrono::steady_clock::now();
             out.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
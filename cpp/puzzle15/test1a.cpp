@@ -5,10 +5,12 @@
 #include "puzzle15.hpp"
 #include "generator15.hpp"
 #include "solver15.hpp"
+#include "bidirectional15.hpp"
+#include "batch_solver15.hpp"
 
 int main() {
     std::mt19937 rng(std::random_device{}()); // 乱数生成器
-    puzzle15::init_manhattan_table(); // マンハッタン距離のテーブルを初期化
+    puzzle15::init_manhattan_table(puzzle15::Puzzle::goal()); // マンハッタン距離のテーブルを初期化（目標は Puzzle::goal()）
 
     int num_problems = 1;
 
@@ -25,6 +27,8 @@ int main() {
     auto goal = puzzle15::Puzzle::goal(); // 目標状態
 
     bool a_star_off =true; // A* Searchをオフにするトグル
+    bool bidirectional_on = false; // 双方向探索 (MM) を A* と比べるトグル
+    bool batch_on = false; // まとめて展開する A* を A* と比べるトグル（-mavx2 を付けるとマンハッタン距離を AVX2 で評価）
 
     // n個の盤面を生成してA* Searchを実行
     if (!a_star_off) {
@@ -34,9 +38,10 @@ int main() {
         int success_count = 0;
 
         std::vector<long long> elapsed_list;
+        solver15::SearchContext<> ctx; // 作業領域は問題の間で使い回す
 
         for (int i = 0; i < puzzle_list.size(); ++i) {
-            auto result = solver15::A_star_path(puzzle_list[i], goal);
+            auto result = solver15::A_star_path(ctx, puzzle_list[i], goal);
             if (result.path) {
                 generated_total += result.generated;
                 elapsed_total += result.elapsed_ms;
@@ -60,6 +65,56 @@ int main() {
 
         std::cout << "\n";
     }
+    // 双方向探索 (MM) と A* の生成ノード数・保持した状態数を比べる
+    if (bidirectional_on) {
+        std::size_t generated_a = 0, generated_mm = 0;
+        std::size_t stored_a = 0, stored_mm = 0;
+        long long elapsed_a = 0, elapsed_mm = 0;
+
+        for (std::size_t i = 0; i < puzzle_list.size(); ++i) {
+            auto a = solver15::A_star_path(puzzle_list[i], goal);
+            auto mm = solver15::bidirectional_path(puzzle_list[i], goal);
+            if (!a.path || !mm.path || a.path->size() != mm.path->size()) {
+                std::cerr << "[ERROR] path length mismatch at i=" << i << "\n";
+                return 1;
+            }
+            generated_a += a.generated;
+            generated_mm += mm.generated;
+            stored_a += a.stored;
+            stored_mm += mm.stored;
+            elapsed_a += a.elapsed_ms;
+            elapsed_mm += mm.elapsed_ms;
+        }
+
+        std::cout << "A* vs MM ( " << num_problems << " problems):\n";
+        std::cout << "Average generated nodes: " << (generated_a / num_problems) << " / " << (generated_mm / num_problems) << "\n";
+        std::cout << "Average stored states: " << (stored_a / num_problems) << " / " << (stored_mm / num_problems) << "\n";
+        std::cout << "Average elapsed time: " << (elapsed_a / num_problems) << " ms / " << (elapsed_mm / num_problems) << " ms\n";
+        std::cout << "\n";
+    }
+    // まとめて展開する A* と 1 ノードずつの A* の時間を比べる
+    if (batch_on) {
+        std::size_t generated_a = 0, generated_b = 0;
+        long long elapsed_a = 0, elapsed_b = 0;
+
+        for (std::size_t i = 0; i < puzzle_list.size(); ++i) {
+            auto a = solver15::A_star_path(puzzle_list[i], goal);
+            auto b = solver15::A_star_batch_path(puzzle_list[i], goal);
+            if (!a.path || !b.path || a.path->size() != b.path->size()) {
+                std::cerr << "[ERROR] path length mismatch at i=" << i << "\n";
+                return 1;
+            }
+            generated_a += a.generated;
+            generated_b += b.generated;
+            elapsed_a += a.elapsed_ms;
+            elapsed_b += b.elapsed_ms;
+        }
+
+        std::cout << "A* vs batch A* ( " << num_problems << " problems):\n";
+        std::cout << "Average generated nodes: " << (generated_a / num_problems) << " / " << (generated_b / num_problems) << "\n";
+        std::cout << "Average elapsed time: " << (elapsed_a / num_problems) << " ms / " << (elapsed_b / num_problems) << " ms\n";
+        std::cout << "\n";
+    }
     // 同様に IDA* を実行
     if (a_star_off) {
         int generated_total_ida = 0;
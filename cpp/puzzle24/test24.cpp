@@ -0,0 +1,53 @@
+#include <random>
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include "../sliding/sliding_puzzle.hpp"
+#include "../sliding/generator.hpp"
+#include "../puzzle15/solver15.hpp"
+
+// 24パズル (5x5) を 15パズルと同じ IDA* エンジンで解く
+// 盤面は 5bit × 25 = 125bit なので unsigned __int128 に詰める
+using Puzzle24 = sliding::SlidingPuzzle<5, 5>;
+
+int main(int argc, char* argv[]) {
+    int num_problems = 10;
+    int steps = 60; // ランダムウォークの手数
+    if (argc >= 2) num_problems = std::atoi(argv[1]);
+    if (argc >= 3) steps = std::atoi(argv[2]);
+
+    std::mt19937 rng(std::random_device{}()); // 乱数生成器
+    const Puzzle24 goal = Puzzle24::goal();
+    const sliding::ManhattanHeuristic<Puzzle24> manhattan(goal);
+
+    std::size_t generated_total = 0;
+    long long elapsed_total = 0;
+    std::size_t path_length_total = 0;
+    int success_count = 0;
+
+    for (int i = 0; i < num_problems; ++i) {
+        const Puzzle24 p = sliding::random_walk<Puzzle24>(steps, rng);
+        auto result = solver15::IDA_star_path(p, goal, manhattan);
+        if (result.path) {
+            generated_total += result.generated;
+            elapsed_total += result.elapsed_ms;
+            path_length_total += result.path->size();
+            success_count++;
+        }
+    }
+
+    std::cout << "24-puzzle IDA* Results ( " << num_problems << " problems, " << steps << " random moves):\n";
+    if (success_count == 0) { // 解が得られなかったときは平均を出さない（0 で割らない）
+        std::cout << "No solution found\n";
+        return 1;
+    }
+    std::cout << "Average generated nodes: " << (generated_total / success_count) << "\n";
+    std::cout << "Average elapsed time: " << (elapsed_total / success_count) << " ms\n";
+    std::cout << "Average path length: " << (path_length_total / success_count) << "\n";
+
+    if (elapsed_total > 0) { // すべて 0 ms で解けたときは出さない
+        double gen_nodes_per_sec = static_cast<double>(generated_total) / (elapsed_total / 1000.0);
+        std::cout << "Generated nodes per second: " << gen_nodes_per_sec << "\n";
+    }
+    return 0;
+}
@@ -1,164 +1,228 @@
 #pragma once
 #include <vector>
-#include <deque>
+#include <memory>
 #include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 #include <limits>
+#include <utility>
+#include <algorithm>
 
 // 二段バケット・プライオリティキュー
 // 第一キー: f（小さいほど先）  範囲 [f_min, f_max]
 // 第二キー: h（小さいほど先）  範囲 [h_min, h_max]
-// 同じ (f,h) では FIFO（先入れ先出し）
+// 同じ (f,h) の中の順序はテンプレート引数 Tie で選ぶ
+//   TieBreak::Fifo  : 先入れ先出し（既定）
+//   TieBreak::Lifo  : 後入れ先出し。直前に展開したノードの子から取り出す
+//   TieBreak::HighG : 第二キーに h の代わりに g を渡し、g が大きいほど先（同じ (f,g) では後入れ先出し）
+//                     f = g + h なら Lifo と同じ順序になる。f と h が独立なときに深さ優先で崩したい場合用
+// PayloadOnly = true なら Entry に f, h を持たず値だけを積む。f, h は top_f() / top_h() でセルの位置から得る
 //
-// 要件：f, h は整数で、事前に範囲がわかっていること
+// 要件：f, h は整数で、事前に範囲がわかっていること。T はデフォルト構築できること
+//
+// 実装
+// - 各 (f,h) セルは連続領域のリングバッファ（空のセルは領域を持たない）
+// - f ごとの行は最初に push されたときに確保するので、コンストラクタはビットマップの確保だけで済む
+// - f ごとに「非空の h」を 64bit ワードのビットマップで持ち、次の非空セルは ctz で探す
+//   （f 自体の非空も同じくビットマップで持つ）
+// - 要素数は全体と f ごとにカウンタで持つ（走査して数え直さない）
+// - clear() は非空のセルだけを空にし、確保した領域は残す（探索の作業領域を使い回すため）
+
+enum class TieBreak { Fifo, Lifo, HighG };
+
+template <class T, bool PayloadOnly>
+struct BucketEntry { // エントリ
+    T value;
+    int f;
+    int h;
+};
 
 template <class T>
+struct BucketEntry<T, true> { // 値だけのエントリ
+    T value;
+};
+
+template <class T, TieBreak Tie = TieBreak::Fifo, bool PayloadOnly = false>
 class BucketPriorityQueue {
 public:
-    struct Entry { // エントリ
-        T value;
-        int f;
-        int h;
-    };
+    using Entry = BucketEntry<T, PayloadOnly>;
 
     BucketPriorityQueue(int f_min, int f_max, int h_min, int h_max)
-        : f_min_(f_min), f_max_(f_max), h_min_(h_min), h_max_(h_max), // 範囲の設定
-          F_(f_max - f_min + 1), H_(h_max - h_min + 1), // バケットのサイズ
-          buckets_(F_, std::vector<std::deque<Entry>>(H_)), // バケットの初期化
-          f_counts_(F_, 0), size_(0), // f レベルごとの非空フラグと全体サイズ
-          cur_f_idx_(-1), cur_h_idx_(-1) // カレントインデックス
+        : f_min_(f_min), f_max_(f_max), h_min_(h_min), h_max_(h_max) // 範囲の設定
     {
         // 範囲の妥当性チェック
         if (f_min_ > f_max_ || h_min_ > h_max_) {
             throw std::invalid_argument("invalid bucket ranges");
         }
+        F_ = f_max - f_min + 1; // バケットのサイズ
+        H_ = h_max - h_min + 1;
+        HW_ = (H_ + 63) / 64; // f 1 行あたりのビットマップのワード数
+        rows_.resize(F_);
+        f_counts_.assign(F_, 0);
+        h_bits_.assign(static_cast<std::size_t>(F_) * HW_, 0);
+        f_bits_.assign((F_ + 63) / 64, 0);
     }
 
     bool empty() const noexcept { return size_ == 0; }
     std::size_t size() const noexcept { return size_; }
 
     // 先頭の要素の取得
-    const T& top() {
-        ensure_cur();
-        const auto& dq = buckets_[cur_f_idx_][cur_h_idx_];
-        return dq.front().value;
+    const T& top() const {
+        check_nonempty();
+        const Ring& r = cell(cur_f_idx_, cur_h_idx_);
+        return (Tie == TieBreak::Fifo ? r.front() : r.back()).value;
+    }
+
+    // 先頭の要素の f, 第二キー（セルの位置から求める）
+    int top_f() const {
+        check_nonempty();
+        return f_min_ + cur_f_idx_;
+    }
+    int top_h() const {
+        check_nonempty();
+        return Tie == TieBreak::HighG ? h_max_ - cur_h_idx_ : h_min_ + cur_h_idx_;
     }
 
     // 取り出し（ポップ）
     void pop() {
-        ensure_cur();
-        auto& dq = buckets_[cur_f_idx_][cur_h_idx_];
-        dq.pop_front();
+        check_nonempty();
+        Ring& r = cell(cur_f_idx_, cur_h_idx_);
+        if (Tie == TieBreak::Fifo) r.pop_front();
+        else r.pop_back();
         --size_;
-        if (dq.empty()) {
+        --f_counts_[cur_f_idx_];
+        if (r.count == 0) {
             // この h バケットが空になったので、次の非空位置へ進める
-            if (--f_h_nonempty_left_ == 0) {
+            clear_bit(h_bits_.data() + static_cast<std::size_t>(cur_f_idx_) * HW_, cur_h_idx_);
+            if (f_counts_[cur_f_idx_] == 0) {
                 // 現在の f レベルが空になった
-                f_counts_[cur_f_idx_] = 0;
+                clear_bit(f_bits_.data(), cur_f_idx_);
+                advance_f(cur_f_idx_ + 1);
+            } else {
+                cur_h_idx_ = next_bit(h_bits_.data() + static_cast<std::size_t>(cur_f_idx_) * HW_, HW_, cur_h_idx_ + 1);
             }
-            advance_to_next_nonempty(cur_f_idx_, cur_h_idx_ + 1);
         }
     }
 
+    // 全要素を捨てる（リングバッファの領域は残すので、次に同じくらい積んでも確保し直さない）
+    void clear() noexcept {
+        for (int fi = next_bit(f_bits_.data(), static_cast<int>(f_bits_.size()), 0); fi >= 0;
+             fi = next_bit(f_bits_.data(), static_cast<int>(f_bits_.size()), fi + 1)) {
+            uint64_t* hb = h_bits_.data() + static_cast<std::size_t>(fi) * HW_;
+            for (int hi = next_bit(hb, HW_, 0); hi >= 0; hi = next_bit(hb, HW_, hi + 1)) {
+                Ring& r = cell(fi, hi);
+                r.head = 0;
+                r.count = 0;
+            }
+            std::fill(hb, hb + HW_, 0);
+            f_counts_[fi] = 0;
+        }
+        std::fill(f_bits_.begin(), f_bits_.end(), 0);
+        size_ = 0;
+        cur_f_idx_ = -1;
+        cur_h_idx_ = -1;
+    }
+
     // 追加（push）
     void push(T value, int f, int h) {
-        if (f < f_min_ || f > f_max_ || h < h_min_ || h > h_max_) {
+        if (f < f_min_ || f > f_max_ || h < h_min_ || h > h_max_) [[unlikely]] {
             throw std::out_of_range("f or h out of configured range");
         }
         const int fi = f - f_min_;
-        const int hi = h - h_min_;
+        const int hi = (Tie == TieBreak::HighG) ? h_max_ - h : h - h_min_; // HighG は大きい g ほど前のセル
 
-        auto& dq = buckets_[fi][hi];
-        const bool was_empty_f = (f_counts_[fi] == 0);
-        const bool was_empty_cell = dq.empty();
+        if (!rows_[fi]) rows_[fi] = std::make_unique<Ring[]>(H_); // f 行を初めて使うときに確保
 
-        dq.push_back(Entry{std::move(value), f, h});
-        ++size_;
-
-        if (was_empty_f) {
-            f_counts_[fi] = 1; // この f レベルに少なくとも1個あることを示す
-        } else if (was_empty_cell) {
-            // 同一 f 内で新しく非空セルが増えたことをカウント（後述参照）
-            // ただし簡略化のためセル数は都度スキャンでもよい。
-        }
+        Ring& r = rows_[fi][hi];
+        if (r.count == 0) set_bit(h_bits_.data() + static_cast<std::size_t>(fi) * HW_, hi);
+        if (f_counts_[fi]++ == 0) set_bit(f_bits_.data(), fi);
+        if constexpr (PayloadOnly) r.push_back(Entry{std::move(value)});
+        else r.push_back(Entry{std::move(value), f, h});
 
         // カレント更新（より小さい (f,h) が来たら先頭に）
-        if (cur_f_idx_ == -1) {
-            // 初要素
+        if (size_++ == 0 || fi < cur_f_idx_ || (fi == cur_f_idx_ && hi < cur_h_idx_)) {
             cur_f_idx_ = fi;
             cur_h_idx_ = hi;
-            // この f レベルの残り非空セル数を概算：スキャン時に埋める
-            f_h_nonempty_left_ = -1; // 未評価フラグ
-        } else {
-            if (fi < cur_f_idx_ || (fi == cur_f_idx_ && hi < cur_h_idx_)) {
-                cur_f_idx_ = fi;
-                cur_h_idx_ = hi;
-                f_h_nonempty_left_ = -1;
-            }
         }
     }
 
 private:
+    // 連続領域のリングバッファ（容量は 2 のべき乗で、満杯になったら倍に伸ばす）
+    struct Ring {
+        std::vector<Entry> buf;
+        std::size_t head = 0;
+        std::size_t count = 0;
+
+        const Entry& front() const noexcept { return buf[head]; }
+        const Entry& back() const noexcept { return buf[(head + count - 1) & (buf.size() - 1)]; }
+
+        void pop_front() noexcept {
+            head = (head + 1) & (buf.size() - 1);
+            --count;
+        }
+        void pop_back() noexcept { --count; }
+
+        void push_back(Entry&& e) {
+            if (count == buf.size()) grow();
+            buf[(head + count) & (buf.size() - 1)] = std::move(e);
+            ++count;
+        }
+
+        void grow() {
+            std::vector<Entry> next(buf.empty() ? 4 : buf.size() * 2);
+            for (std::size_t i = 0; i < count; ++i) next[i] = std::move(buf[(head + i) & (buf.size() - 1)]);
+            buf.swap(next);
+            head = 0;
+        }
+    };
+
     int f_min_, f_max_, h_min_, h_max_;
-    int F_, H_;
+    int F_, H_, HW_;
 
-    // buckets_[fi][hi] に (f_min_+fi, h_min_+hi) の要素群
-    std::vector<std::vector<std::deque<Entry>>> buckets_;
-    // f レベルごとの「何か入っているか」のフラグ（>0 で非空）
-    std::vector<int> f_counts_;
+    // rows_[fi][hi] に (f_min_+fi, h_min_+hi) の要素群
+    std::vector<std::unique_ptr<Ring[]>> rows_;
+    // f レベルごとの要素数
+    std::vector<std::size_t> f_counts_;
+    // h_bits_[fi * HW_ + w]: f レベル fi で非空の h のビットマップ, f_bits_: 非空の f のビットマップ
+    std::vector<uint64_t> h_bits_;
+    std::vector<uint64_t> f_bits_;
 
-    std::size_t size_;
-    int cur_f_idx_;
-    int cur_h_idx_;
+    std::size_t size_ = 0;
+    int cur_f_idx_ = -1;
+    int cur_h_idx_ = -1;
 
-    // 最適化用：現在の f レベルで非空の h バケット残数（未評価は -1）
-    int f_h_nonempty_left_ = -1;
+    Ring& cell(int fi, int hi) const noexcept { return rows_[fi][hi]; }
 
-    void ensure_cur() {
+    void check_nonempty() const {
         if (size_ == 0) [[unlikely]] {
             throw std::runtime_error("BucketPriorityQueue::top/pop on empty");
         }
-        if (cur_f_idx_ == -1) {
-            advance_to_next_nonempty(0, 0);
-        }
     }
 
-    // 現在カーソルを、辞書式順序 (f,h) 最小の非空バケットへ進める。
-    // h_start は同一 f 内での開始 h 位置。
-    void advance_to_next_nonempty(int f_start, int h_start) {
-        // まず f を前へ
-        for (int fi = std::max(0, f_start); fi < F_; ++fi) {
-            if (f_counts_[fi] == 0) continue; // この f は空
-
-            // h の開始位置を決める
-            int hi0 = (fi == f_start) ? std::max(0, h_start) : 0;
-
-            // 現 f レベルで非空 h を探す
-            for (int hi = hi0; hi < H_; ++hi) {
-                if (!buckets_[fi][hi].empty()) {
-                    cur_f_idx_ = fi;
-                    cur_h_idx_ = hi;
-
-                    // 現 f レベルの非空セル残数を（ざっくり）数え直す
-                    // ※ O(H) だが H が小さめなら十分実用。高速化したければ
-                    //   各 (fi,hi) の非空→空/空→非空でカウンタを更新する設計に。
-                    int cnt = 0;
-                    for (int k = 0; k < H_; ++k) {
-                        if (!buckets_[fi][k].empty()) ++cnt;
-                    }
-                    f_h_nonempty_left_ = cnt;
-                    return;
-                }
-            }
-
-            // この f に要素があるはずなのに見つからない？
-            // → すべて他の場所に移動して 0 になっている可能性
-            // 念のためクリア
-            f_counts_[fi] = 0;
+    static void set_bit(uint64_t* bits, int i) noexcept { bits[i >> 6] |= uint64_t(1) << (i & 63); }
+    static void clear_bit(uint64_t* bits, int i) noexcept { bits[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+
+    // 位置 from 以降で最初に立っているビット（無ければ -1）
+    static int next_bit(const uint64_t* bits, int words, int from) noexcept {
+        int w = from >> 6;
+        if (w >= words) return -1;
+        uint64_t x = bits[w] & (~uint64_t(0) << (from & 63));
+        while (x == 0) {
+            if (++w >= words) return -1;
+            x = bits[w];
         }
+        return (w << 6) + __builtin_ctzll(x);
+    }
 
-        // ここに来るのは size_==0 のときのみのはず
-        cur_f_idx_ = -1;
-        cur_h_idx_ = -1;
+    // f レベル f_start 以降で最小の非空セルへカーソルを進める
+    void advance_f(int f_start) noexcept {
+        const int fi = next_bit(f_bits_.data(), static_cast<int>(f_bits_.size()), f_start);
+        if (fi < 0) { // ここに来るのは size_==0 のときのみ
+            cur_f_idx_ = -1;
+            cur_h_idx_ = -1;
+            return;
+        }
+        cur_f_idx_ = fi;
+        cur_h_idx_ = next_bit(h_bits_.data() + static_cast<std::size_t>(fi) * HW_, HW_, 0);
     }
 };
@@ -1,5 +1,8 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include "puzzle.hpp"
+#include "linear_conflict.hpp"
 
 namespace puzzle8 {
 
@@ -18,8 +21,114 @@ inline int manhattan_heuristic(const Puzzle& p) {
     return static_cast<int>(p.hman); // 差分管理している値をそのまま返す
 }
 
+// マンハッタン距離 + 線形衝突 + コーナータイル/最終手
+inline int linear_conflict_heuristic(const Puzzle& p) {
+    return static_cast<int>(p.hman) + linear_conflict_lines(p.board) + corner_last_move_extra(p.board);
+}
+
 inline int const_heuristic(const Puzzle& p) {
     return 0;
 }
 
+// ---------------------------------------------------------------------------
+// 探索器に渡す差分評価器（要件は sliding::is_incremental_heuristic）
+// reset: 盤面から h を求める, update: タイル t が from → to へ動いたときの h, undo: 内部状態を戻す
+
+// MDIST[タイル][位置] = 目標位置までのマンハッタン距離（空白は 0）
+inline constexpr auto MDIST = [] {
+    std::array<std::array<uint8_t, 9>, 9> t{};
+    for (int v = 1; v < 9; ++v) {
+        for (int pos = 0; pos < 9; ++pos) {
+            const int dr = (v - 1) / 3 - pos / 3, dc = (v - 1) % 3 - pos % 3;
+            t[v][pos] = static_cast<uint8_t>((dr < 0 ? -dr : dr) + (dc < 0 ? -dc : dc));
+        }
+    }
+    return t;
+}();
+
+struct ZeroHeuristic { // h = 0（ダイクストラ法と同じ）
+    inline int reset(const Puzzle&) const noexcept { return 0; }
+    inline int update(int, uint8_t, int, int) const noexcept { return 0; }
+    inline void undo(uint8_t, int, int) const noexcept {}
+};
+
+struct MisplacedHeuristic {
+    inline int reset(const Puzzle& s) const noexcept { return misplaced_heuristic(s); }
+    inline int update(int h, uint8_t t, int from, int to) const noexcept {
+        return h + (t == from + 1) - (t == to + 1); // 正しい位置から外れたら +1、入ったら -1
+    }
+    inline void undo(uint8_t, int, int) const noexcept {}
+};
+
+struct ManhattanHeuristic {
+    inline int reset(const Puzzle& s) const noexcept { return manhattan_heuristic(s); } // 差分管理している値
+    inline int update(int h, uint8_t t, int from, int to) const noexcept {
+        return h - MDIST[t][from] + MDIST[t][to];
+    }
+    inline void undo(uint8_t, int, int) const noexcept {}
+};
+
+// マンハッタン距離 + 線形衝突 + コーナータイル/最終手
+// 盤面を持っておき、動いたタイルが通る 2 本のラインだけ表を引き直す。
+// コーナー/最終手の項は、動いたタイルか空白がコーナーのセルに触れるか、タイル 6, 8 が動くか、
+// 変わる 2 本のラインが watch のセルを通るときだけ引き直し、undo では引き直さずに積んだ値へ戻す
+struct LinearConflictHeuristic {
+    struct Saved {
+        uint32_t watch;
+        int extra;
+    };
+
+    uint64_t board = 0;
+    int extra = 0;           // 今の盤面のコーナー/最終手の追加手数
+    uint32_t watch = 0;      // corner_last_move_extra が返したセル
+    uint8_t last_pos[2]{};   // タイル 6, 8 の位置
+    std::array<Saved, Grid::MAX_DEPTH + 1> saved{}; // update ごとに積み、undo で戻す
+    int depth = 0;
+
+    inline int reset(const Puzzle& s) noexcept {
+        board = s.board;
+        depth = 0;
+        lc_last_positions(board, last_pos);
+        extra = corner_last_move_extra(board, last_pos, watch);
+        return static_cast<int>(s.hman) + linear_conflict_lines(board) + extra;
+    }
+
+    inline int update(int h, uint8_t t, int from, int to) noexcept {
+        const uint64_t before = board;
+        set_nibble(board, from, 0);
+        set_nibble(board, to, t);
+
+        int lines = 0;
+        uint32_t line_cells = 0; // 変わる 2 本のラインのセル
+        if (row(from) == row(to)) { // 横移動 → 2 本の列が変わる
+            const int c0 = col(from), c1 = col(to);
+            lines = lc_col(board, c0) + lc_col(board, c1) - lc_col(before, c0) - lc_col(before, c1);
+            line_cells = (0x49u << c0) | (0x49u << c1);
+        } else { // 縦移動 → 2 本の行が変わる
+            const int r0 = row(from), r1 = row(to);
+            lines = lc_row(board, r0) + lc_row(board, r1) - lc_row(before, r0) - lc_row(before, r1);
+            line_cells = (0x7u << (3 * r0)) | (0x7u << (3 * r1));
+        }
+
+        const int prev = extra;
+        saved[depth++] = Saved{watch, extra};
+        const int k = lc_last_index(t);
+        if (k >= 0) last_pos[k] = static_cast<uint8_t>(to);
+        if (k >= 0 || (((1u << from) | (1u << to)) & LC8_CORNER_CELLS) || (line_cells & watch)) {
+            extra = corner_last_move_extra(board, last_pos, watch);
+        }
+        return h - MDIST[t][from] + MDIST[t][to] + lines - prev + extra;
+    }
+
+    inline void undo(uint8_t t, int from, int to) noexcept {
+        set_nibble(board, to, 0);
+        set_nibble(board, from, t);
+        const int k = lc_last_index(t);
+        if (k >= 0) last_pos[k] = static_cast<uint8_t>(from);
+        const Saved& s = saved[--depth];
+        watch = s.watch;
+        extra = s.extra;
+    }
+};
+
 } // namespace puzzle8
\ No newline at end of file
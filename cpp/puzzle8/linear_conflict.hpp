@@ -0,0 +1,160 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+// 8パズル用の線形衝突 (Linear Conflict) 表
+//
+// 目標状態は Puzzle::goal() と同じ（タイル t はセル t-1、空白はセル 8）。
+// 1 行（1 列）の 3 ニブル = 12bit をキーにして、その行（列）の衝突による追加手数を引く。
+// 空白を横に動かしても行内のタイルの並び順は変わらないので、横移動で変わるのは 2 本の列だけ、
+// 縦移動で変わるのは 2 本の行だけ。LinearConflictHeuristic (heuristic.hpp) が表引き 4 回で差分更新する。
+//
+// 表の値: 下位 4bit = 追加手数 (2 × 取り除くべきタイル数), 上位 4bit = 衝突に関わるセル (行/列内の位置)
+
+namespace puzzle8 {
+
+struct LinearConflictTable {
+    std::array<std::array<uint8_t, 1 << 12>, 3> row{};
+    std::array<std::array<uint8_t, 1 << 12>, 3> col{};
+
+    // 目標位置の並び (このラインに属さないタイルは -1) から衝突を求める
+    static uint8_t entry(const int* goal_idx) {
+        int best = 0, members = 0;
+        for (int i = 0; i < 3; ++i) {
+            if (goal_idx[i] >= 0) ++members;
+        }
+        // 残すタイルが目標順に並ぶ最大集合 (LIS) を全部分集合から求める
+        for (int mask = 0; mask < 8; ++mask) {
+            int last = -1, cnt = 0;
+            bool ok = true;
+            for (int i = 0; i < 3 && ok; ++i) {
+                if (!(mask & (1 << i))) continue;
+                if (goal_idx[i] < 0 || goal_idx[i] <= last) ok = false;
+                last = goal_idx[i];
+                ++cnt;
+            }
+            if (ok && cnt > best) best = cnt;
+        }
+        int involved = 0;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = i + 1; j < 3; ++j) {
+                if (goal_idx[i] >= 0 && goal_idx[j] >= 0 && goal_idx[i] > goal_idx[j]) involved |= (1 << i) | (1 << j);
+            }
+        }
+        return static_cast<uint8_t>(2 * (members - best) | (involved << 4));
+    }
+
+    LinearConflictTable() {
+        for (int line = 0; line < 3; ++line) {
+            for (int key = 0; key < (1 << 12); ++key) {
+                int row_idx[3], col_idx[3];
+                for (int i = 0; i < 3; ++i) {
+                    const int t = (key >> (i * 4)) & 0xF;
+                    const int g = t - 1; // 目標セル
+                    const bool valid = (t >= 1 && t <= 8);
+                    row_idx[i] = (valid && g / 3 == line) ? g % 3 : -1;
+                    col_idx[i] = (valid && g % 3 == line) ? g / 3 : -1;
+                }
+                row[line][key] = entry(row_idx);
+                col[line][key] = entry(col_idx);
+            }
+        }
+    }
+};
+
+inline const LinearConflictTable LC8{}; // 起動時に一度だけ構築（3 × 4096 × 2 バイト）
+
+static inline uint32_t lc_row_key(uint64_t b, int r) noexcept {
+    return static_cast<uint32_t>((b >> (r * 12)) & 0xFFFu);
+}
+
+static inline uint32_t lc_col_key(uint64_t b, int c) noexcept {
+    const uint64_t x = b >> (c * 4);
+    return static_cast<uint32_t>((x & 0xFu) | ((x >> 8) & 0xF0u) | ((x >> 16) & 0xF00u));
+}
+
+static inline int lc_row(uint64_t b, int r) noexcept { return LC8.row[r][lc_row_key(b, r)] & 0xF; }
+static inline int lc_col(uint64_t b, int c) noexcept { return LC8.col[c][lc_col_key(b, c)] & 0xF; }
+
+inline int linear_conflict_lines(uint64_t b) noexcept {
+    int d = 0;
+    for (int i = 0; i < 3; ++i) d += lc_row(b, i) + lc_col(b, i);
+    return d;
+}
+
+// セル pos のタイルが行か列の衝突に関わっているか
+static inline bool lc_involved(uint64_t b, int pos) noexcept {
+    const int r = pos / 3, c = pos % 3;
+    return ((LC8.row[r][lc_row_key(b, r)] >> 4) & (1 << c)) || ((LC8.col[c][lc_col_key(b, c)] >> 4) & (1 << r));
+}
+
+// 目標盤面 (Puzzle::goal() と同じ) の 36bit
+inline constexpr uint64_t LC8_GOAL_PACKED = [] {
+    uint64_t b = 0;
+    for (int i = 0; i < 8; ++i) b |= static_cast<uint64_t>(i + 1) << (i * 4);
+    return b;
+}();
+
+// コーナー: {角, 隣接セル, 隣接セル}。右下 (8) は目標の空白なので対象外
+inline constexpr int LC8_CORNER[3][3] = {{0, 1, 3}, {2, 1, 5}, {6, 7, 3}};
+inline constexpr uint32_t LC8_CORNER_CELLS = 0xEFu; // 上のセルすべて (4 と 8 以外)
+// 最終手: 最後に動くのはセル 8 にあるタイル 6（→ セル 5）かタイル 8（→ セル 7）
+inline constexpr int LC8_LAST_CELL[2] = {5, 7};
+static inline int lc_last_index(int t) noexcept { return t == 6 ? 0 : t == 8 ? 1 : -1; }
+
+// タイル 6, 8 の位置を盤面から探す
+inline void lc_last_positions(uint64_t b, uint8_t* pos) noexcept {
+    for (int p = 0; p < 9; ++p) {
+        const int k = lc_last_index(static_cast<int>((b >> (p * 4)) & 0xF));
+        if (k >= 0) pos[k] = static_cast<uint8_t>(p);
+    }
+}
+
+// コーナータイルと最終手による追加手数（pos[k] はタイル 6, 8 の位置）
+// 同じタイルの余分な 2 手を二重に数えないよう、使ったセルを除外しながら足す。
+// watch には、そのセルを通る行か列の衝突が変わると結果も変わりうるセルを入れる
+inline int corner_last_move_extra(uint64_t b, const uint8_t* pos, uint32_t& watch) noexcept {
+    auto tile_at = [&](int i) { return static_cast<int>((b >> (i * 4)) & 0xF); };
+    auto goal_tile = [](int i) { return i == 8 ? 0 : i + 1; };
+
+    watch = 0;
+    if (b == LC8_GOAL_PACKED) return 0;
+
+    int extra = 0;
+    uint32_t used = 0;
+
+    // コーナー: 角のタイルが違い、隣接 2 セルが正しく（かつ衝突に無関係）なら、どちらかが一度どく
+    for (const auto& cn : LC8_CORNER) {
+        const int c = cn[0], a = cn[1], v = cn[2];
+        if (tile_at(c) == goal_tile(c)) continue;
+        if (tile_at(a) != goal_tile(a) || tile_at(v) != goal_tile(v)) continue;
+        watch |= (1u << a) | (1u << v);
+        if ((used & ((1u << a) | (1u << v))) || lc_involved(b, a) || lc_involved(b, v)) continue;
+        used |= (1u << a) | (1u << v);
+        extra += 2;
+    }
+
+    // 最終手: タイル 6, 8 のどちらも現在位置からセル 8 を経由すると 2 手余分にかかるなら 2 を足す
+    uint32_t last = 0;
+    bool ok = true;
+    for (int k = 0; k < 2; ++k) {
+        const int n = LC8_LAST_CELL[k], p = pos[k];
+        const int via = std::abs(p / 3 - 2) + std::abs(p % 3 - 2) + 1;
+        const int direct = std::abs(p / 3 - n / 3) + std::abs(p % 3 - n % 3);
+        if (via == direct) return extra; // 位置だけで決まる（衝突には依らない）
+        last |= 1u << p;
+        if ((used & (1u << p)) || lc_involved(b, p)) ok = false;
+    }
+    watch |= last;
+    return ok ? extra + 2 : extra;
+}
+
+inline int corner_last_move_extra(uint64_t b) noexcept {
+    uint8_t pos[2];
+    uint32_t watch;
+    lc_last_positions(b, pos);
+    return corner_last_move_extra(b, pos, watch);
+}
+
+} // namespace puzzle8
@@ -9,27 +9,31 @@
 #include <utility>
 #include <functional>
 #include <cstdlib>
+#include "../sliding/sliding_puzzle.hpp"
 
 namespace puzzle8 {
 
+// 盤面の形と格納方法は共通コア (sliding::Grid<3, 3>, 4bit ニブル) を使う
+using Grid = sliding::Grid<3, 3>;
+using Storage = sliding::StoragePolicy<9>;
+
 // 3x3 の座標と一次元indexの相互変換関数
 static inline int row(int idx) {
-    return idx / 3;
+    return Grid::row(idx);
 }
 static inline int col(int idx) {
-    return idx % 3;
+    return Grid::col(idx);
 }
 static inline int idx(int r, int c) {
-    return r * 3 + c;
+    return Grid::idx(r, c);
 }
 
 // 4bitづつインデックスの値を書き込む (先頭4bitは0番目のタイルの値などのようにする)
 static inline uint8_t get_nibble(uint64_t x, int i) {
-    return static_cast<uint8_t>((x >> (i * 4)) & 0xF);
+    return Storage::get(x, i);
 }
 static inline void set_nibble(uint64_t &x, int i, uint8_t v) {
-    const uint64_t mask = ~(0xFULL << (i * 4));
-    x = (x & mask) | (static_cast<uint64_t>(v & 0xF) << (i * 4));
+    Storage::set(x, i, v);
 }
 
 struct Puzzle {
@@ -37,7 +41,7 @@ struct Puzzle {
     uint8_t  zero_pos = 0; // 空白の位置
     uint8_t  hman = 0; // マンハッタン距離
 
-    enum class Move : uint8_t { Up=0, Down=1, Left=2, Right=3 };
+    using Move = sliding::Move;
 
     // 目標状態
     static Puzzle goal() {
@@ -102,27 +106,12 @@ struct Puzzle {
 
     // 空白を動かせるか判定する関数
     static inline bool can_move(int zero, Move m) {
-        int r = row(zero), c = col(zero);
-        switch (m) {
-            case Move::Up: return r > 0;
-            case Move::Down: return r < 2;
-            case Move::Left: return c > 0;
-            case Move::Right: return c < 2;
-        }
-        return false;
+        return Grid::target(zero, m) >= 0; // コンパイル時の隣接表を引く
     }
 
     // インプレース移動と差分マンハッタンを計算する関数
     inline void move_inplace(Move m) {
-        int zr = row(zero_pos), zc = col(zero_pos);
-        int nr = zr, nc = zc;
-        switch (m) {
-            case Move::Up: --nr; break;
-            case Move::Down: ++nr; break;
-            case Move::Left: --nc; break;
-            case Move::Right: ++nc; break;
-        }
-        int to = idx(nr, nc);
+        const int to = Grid::target(zero_pos, m);
         uint8_t tile = get_nibble(board, to);
         // 差分更新
         if (tile != 0) {
@@ -163,13 +152,7 @@ struct Puzzle {
 
     // 逆操作
     static inline Move inverse(Move m) noexcept {
-        switch (m) {
-            case Move::Up: return Move::Down;
-            case Move::Down: return Move::Up;
-            case Move::Left: return Move::Right;
-            case Move::Right: return Move::Left;
-        }
-        return Move::Up;
+        return sliding::inverse_move(m);
     }
 
     // 0..8 がちょうど一回ずつ現れるか確認する関数
@@ -0,0 +1,155 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "puzzle.hpp"
+
+// 8パズルの盤面の完全ハッシュ（ランキング）と全状態の距離表
+//
+// ランク = 空白の位置 × 20160 + (空白を除いた 8 タイルの並びの Lehmer 符号順位) / 2
+//   8 タイルの並びの Lehmer 符号は d0..d7 (d7 = 0)。3x3 では空白を動かしてもタイルの並びの転倒数の偶奇は
+//   変わらないので、目標盤面から到達できる盤面は転倒数が偶数の並びだけ。
+//   d6 ∈ {0,1} は残りの桁の偶奇で決まるので、順位を 2 で割れば偶数の並びの中で 0..20159 に詰まる。
+// よって到達可能な 9!/2 = 181,440 状態が 0..181439 に重複なく並ぶ（転倒数が奇数の盤面には使わない）。
+//
+// 距離表は目標盤面 Puzzle::goal() からの幅優先探索で作る（1 状態 1 バイト）。
+
+namespace puzzle8 {
+
+constexpr uint32_t NUM_STATES = 181440; // 9! / 2
+constexpr uint32_t PERMS_PER_BLANK = 20160; // 8! / 2
+constexpr uint8_t  UNREACHABLE = 0xFF;
+
+// 空白を除いたタイル列の転倒数の偶奇（幅 3 は奇数なので、手を打っても変わらない）
+inline int tile_parity(uint64_t board) noexcept {
+    int inv = 0;
+    uint32_t seen = 0; // 既に現れたタイルの集合
+    for (int i = 0; i < 9; ++i) {
+        const int t = get_nibble(board, i);
+        if (t == 0) continue;
+        inv += __builtin_popcount(seen >> t); // 先に現れた t より大きいタイルの数
+        seen |= 1u << t;
+    }
+    return inv & 1;
+}
+
+// 空白を除いたタイル列の転倒数が偶数か（目標盤面 1..8 と同じ偶奇なら解ける）
+inline bool is_solvable(uint64_t board) noexcept {
+    return tile_parity(board) == 0;
+}
+
+// start から goal へ行けるか（goal は Puzzle::goal() でなくてもよい）
+inline bool is_solvable(const Puzzle& start, const Puzzle& goal) noexcept {
+    return tile_parity(start.board) == tile_parity(goal.board);
+}
+
+// 盤面 → ランク
+inline uint32_t rank_board(uint64_t board) noexcept {
+    static constexpr uint32_t FACT[8] = {5040, 720, 120, 24, 6, 2, 1, 1}; // (7-i)!
+    uint32_t r = 0;
+    uint32_t used = 0; // 使ったタイルの集合（bit t）
+    int blank = 0, k = 0;
+    for (int i = 0; i < 9; ++i) {
+        const int t = get_nibble(board, i);
+        if (t == 0) {
+            blank = i;
+            continue;
+        }
+        // 残っているタイルのうち t より小さいものの数 = Lehmer 符号の桁
+        const uint32_t d = static_cast<uint32_t>(t - 1) - __builtin_popcount(used & ((1u << t) - 1));
+        r += d * FACT[k++];
+        used |= 1u << t;
+    }
+    return static_cast<uint32_t>(blank) * PERMS_PER_BLANK + r / 2;
+}
+
+// ランク → 盤面（空白の位置も返す）
+inline uint64_t unrank_board(uint32_t rank, uint8_t& zero_pos) noexcept {
+    static constexpr uint32_t FACT[8] = {5040, 720, 120, 24, 6, 2, 1, 1};
+    const int blank = static_cast<int>(rank / PERMS_PER_BLANK);
+    uint32_t r = (rank % PERMS_PER_BLANK) * 2;
+
+    int digit[8];
+    int parity = 0;
+    for (int k = 0; k < 6; ++k) {
+        digit[k] = static_cast<int>(r / FACT[k]);
+        r %= FACT[k];
+        parity += digit[k];
+    }
+    digit[6] = parity & 1; // 転倒数の合計が偶数になるように決める
+    digit[7] = 0;
+
+    uint64_t board = 0;
+    uint32_t remain = 0x1FE; // 残っているタイル 1..8
+    int k = 0;
+    for (int i = 0; i < 9; ++i) {
+        if (i == blank) continue;
+        // 残りのタイルのうち digit[k] 番目に小さいもの
+        uint32_t x = remain;
+        for (int j = 0; j < digit[k]; ++j) x &= x - 1;
+        const int t = __builtin_ctz(x);
+        remain &= ~(1u << t);
+        set_nibble(board, i, static_cast<uint8_t>(t));
+        ++k;
+    }
+    zero_pos = static_cast<uint8_t>(blank);
+    return board;
+}
+
+inline uint32_t rank_puzzle(const Puzzle& p) noexcept { return rank_board(p.board); }
+
+inline Puzzle unrank_puzzle(uint32_t rank) {
+    uint8_t zero = 0;
+    const uint64_t board = unrank_board(rank, zero);
+    Puzzle p;
+    p.board = board;
+    p.recompute_manhattan(); // zero_pos と hman も合わせる
+    return p;
+}
+
+// 目標盤面からの最短手数の表（到達不能は UNREACHABLE）
+struct DistanceTable {
+    std::vector<uint8_t> dist;
+    int max_distance = 0;
+
+    DistanceTable() : dist(NUM_STATES, UNREACHABLE) {
+        // 幅優先探索（キューはランクの配列で、層ごとに先頭から順に処理する）
+        std::vector<uint32_t> queue;
+        queue.reserve(NUM_STATES);
+        const uint32_t g = rank_board(Puzzle::goal().board);
+        dist[g] = 0;
+        queue.push_back(g);
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            const uint32_t r = queue[head];
+            const uint8_t d = dist[r];
+            uint8_t zero = 0;
+            const uint64_t board = unrank_board(r, zero);
+            for (Puzzle::Move m : sliding::MOVES) {
+                const int to = Grid::target(zero, m);
+                if (to < 0) continue;
+                uint64_t next = board;
+                set_nibble(next, zero, get_nibble(board, to));
+                set_nibble(next, to, 0);
+                const uint32_t nr = rank_board(next);
+                if (dist[nr] != UNREACHABLE) continue;
+                dist[nr] = static_cast<uint8_t>(d + 1);
+                queue.push_back(nr);
+            }
+        }
+        max_distance = dist[queue.back()];
+    }
+
+    // 盤面の目標までの最短手数（解けない盤面は -1）
+    int distance(uint64_t board) const noexcept {
+        if (!is_solvable(board)) return -1;
+        return dist[rank_board(board)];
+    }
+};
+
+// 最初に使うときに一度だけ構築する
+inline const DistanceTable& distance_table() {
+    static const DistanceTable table;
+    return table;
+}
+
+} // namespace puzzle8
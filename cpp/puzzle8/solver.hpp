@@ -1,16 +1,16 @@
 #pragma once
 #include <queue>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
-#include <functional>
 #include <optional>
 #include <algorithm>
 #include <chrono>
 #include <sstream>
+#include <stdexcept>
 #include "puzzle.hpp"
 #include "heuristic.hpp"
+#include "rank.hpp"
 #include "bucket_pq.hpp"
+#include "../sliding/flat_table.hpp"
 
 namespace solver {
 
@@ -18,33 +18,45 @@ struct SearchResult { // 探索結果用の構造体
     std::optional<std::vector<puzzle8::Puzzle::Move>> path;
     std::size_t generated = 0;
     long long elapsed_ms = 0;
+    bool unsolvable = false; // start から goal へ行けない（偶奇が違うので探索せずに返した。path は空）
 };
 
-using Heuristic = std::function<int(const puzzle8::Puzzle&)>; // ヒューリスティック関数の型
+// A* の作業領域（オープンリストと状態表）
+// 問題ごとに作り直すと確保とページフォールトが探索そのものより高くつくので、
+// 何問も解くときは 1 つ作って A_star_path に渡す。reset() は中身を消すだけで、確保した領域は残す
+template <TieBreak Tie = TieBreak::Fifo>
+struct SearchContext {
+    BucketPriorityQueue<puzzle8::Puzzle, Tie, true> open{0, 200, 0, 200}; // 盤面だけを積む（f, h はバケットの位置からわかる）
+    sliding::FlatStateTable<uint64_t> table{1 << 12}; // g, h, closed, 親からの手を 1 スロットに集約（盤面は board をキーにする）
+
+    void reset() noexcept {
+        open.clear();
+        table.clear();
+    }
+};
 
 // A* Search 
+// Tie は同じ (f,h) の中の順序（bucket_pq.hpp の TieBreak）
+// H は reset / update / undo を持つ差分評価器（heuristic.hpp の ManhattanHeuristic など）
+// ctx の中身は最初に消す（前の問題の結果は残らない）
+template <TieBreak Tie = TieBreak::Fifo, class H = puzzle8::ZeroHeuristic>
 inline SearchResult
-A_star_path(const puzzle8::Puzzle& start,
+A_star_path(SearchContext<Tie>& ctx,
+            const puzzle8::Puzzle& start,
             const puzzle8::Puzzle& goal,
-            Heuristic h = puzzle8::const_heuristic) {
+            H heur = H{}) {
+    static_assert(sliding::is_incremental_heuristic_v<H, puzzle8::Puzzle>, "H must provide reset / update / undo");
     using puzzle8::Puzzle;
 
     auto t0 = std::chrono::steady_clock::now();
     std::size_t generated = 0;
 
-    struct Node {
-        int f; // プライオリティ値
-        int g; // 実コスト（手数）
-        int h; // ヒューリスティック値
-        Puzzle s; // 現在の状態
-    };
-
-    struct Cmp { // 比較関数
-        bool operator()(const Node& a, const Node& b) const noexcept {
-            if (a.f != b.f) return a.f > b.f; // fが異なるならfが小さい方が優先
-            return a.h > b.h; // 同点ならhが小さい方を優先
-        }
-    };
+    // 偶奇が違えば行けない（探索すると到達できる半分の 181,440 状態をすべて調べてしまう）
+    if (!puzzle8::is_solvable(start, goal)) {
+        SearchResult out;
+        out.unsolvable = true;
+        return out;
+    }
 
     if (start == goal) { // もし開始状態が目標状態なら
         auto t1 = std::chrono::steady_clock::now();
@@ -55,37 +67,43 @@ A_star_path(const puzzle8::Puzzle& start,
         };
     }
 
-    BucketPriorityQueue<Node> open(0, 200, 0, 200); // オープンリストのデータ構造
-    std::unordered_set<Puzzle, puzzle8::PuzzleHash> closed; // クローズドリストのデータ構造
-    std::unordered_map<Puzzle, int, puzzle8::PuzzleHash> gscore; // g値のマップ
-    std::unordered_map<Puzzle, int, puzzle8::PuzzleHash> hscore; // h値のマップ
-    std::unordered_map<Puzzle, std::pair<Puzzle, Puzzle::Move>, puzzle8::PuzzleHash> parent; // <子状態, (親状態, 打った手)>
-
-    int hstart = h(start);
-    open.push(Node{hstart, 0, hstart, start}, hstart, hstart);
-    gscore[start] = 0;
-    hscore[start] = hstart;
+    ctx.reset();
+    auto& open = ctx.open;
+    auto& table = ctx.table;
+    // 第二キー: 通常は h、HighG のときは g
+    auto second_key = [](int g, int h) { return Tie == TieBreak::HighG ? g : h; };
+
+    int hstart = heur.reset(start);
+    open.push(start, hstart, second_key(0, hstart));
+    {
+        auto& root = *table.insert(start.board).first;
+        root.g = 0;
+        root.h = static_cast<uint8_t>(hstart);
+    }
 
     constexpr Puzzle::Move MOVES[4] = {
         Puzzle::Move::Up, Puzzle::Move::Down, Puzzle::Move::Left, Puzzle::Move::Right
     };
 
     while (!open.empty()) {
-        Node cur = open.top(); // オープンリストから最小のノードを取得
+        const Puzzle s = open.top(); // オープンリストから最小のノードを取得
+        const int g_cur = (Tie == TieBreak::HighG) ? open.top_h() : open.top_f() - open.top_h();
         open.pop(); // オープンリストからノードを削除
 
-        auto itg = gscore.find(cur.s);
-        if (itg != gscore.end() && cur.g > itg->second) continue;
+        auto* slot = table.find(s.board);
+        if (g_cur > slot->g) continue;
 
         // ゴール条件を満たした場合
-        if (cur.s == goal) {
+        if (s == goal) {
+            // 親の盤面は子の盤面で手を戻して得る
             std::vector<Puzzle::Move> path;
-            Puzzle x = cur.s;
+            path.reserve(g_cur); // 結果の経路は 1 回の確保で済ませる
+            Puzzle x = s;
             while (!(x == start)) {
-                auto itp = parent.find(x);
-                if (itp == parent.end()) break; // ありえないが念のため
-                path.push_back(itp->second.second);
-                x = itp->second.first;
+                const auto* sx = table.find(x.board);
+                if (!sx || !sx->move()) break; // ありえないが念のため
+                path.push_back(*sx->move());
+                x.move_inplace(Puzzle::inverse(*sx->move()));
             }
             std::reverse(path.begin(), path.end()); // スタートからゴールへの経路にする
             auto t1 = std::chrono::steady_clock::now();
@@ -98,29 +116,31 @@ A_star_path(const puzzle8::Puzzle& start,
 
         // クローズドリストへの追加
         // 遅延重複検出
-        if (!closed.insert(cur.s).second) continue; // falseならすでに訪問済みなのでスキップする
+        if (slot->closed()) continue; // すでに訪問済みなのでスキップする
+        slot->set_closed();
 
-        
+        const int h_parent = heur.reset(s); // 差分評価器を親の盤面に合わせる
 
         // ノードの拡張 (Expand)
         for (auto m : MOVES) {
-            if (!Puzzle::can_move(cur.s.zero_pos, m)) continue; // 移動できない場合はスキップ
-            Puzzle nxt = cur.s;
+            if (!Puzzle::can_move(s.zero_pos, m)) continue; // 移動できない場合はスキップ
+            Puzzle nxt = s;
             nxt.move_inplace(m);
-            int tentative_g = cur.g + 1; // 暫定的な g 値
+            int tentative_g = g_cur + 1; // 暫定的な g 値
 
             // 即時重複検出
-            auto it = gscore.find(nxt); // gscore に存在するか確認
-            if (it != gscore.end() && tentative_g >= it->second) continue; // 既存の経路よりも悪い場合はスキップ
+            auto [it, inserted] = table.insert(nxt.board);
+            if (!inserted && tentative_g >= it->g) continue; // 既存の経路よりも悪い場合はスキップ
 
-            int h_value = h(nxt);
+            // タイルは nxt.zero_pos から s.zero_pos へ動いた
+            const uint8_t tile = puzzle8::get_nibble(s.board, nxt.zero_pos);
+            int h_value = heur.update(h_parent, tile, nxt.zero_pos, s.zero_pos);
+            heur.undo(tile, nxt.zero_pos, s.zero_pos);
 
-            parent[nxt] = std::make_pair(cur.s, m); // 親と手を更新
-            gscore[nxt] = tentative_g; // g 値を更新
-            hscore[nxt] = h_value; // h 値を更新
+            it->assign(tentative_g, h_value, m, s.zero_pos); // g, h, 親からの手を更新
             int f_value = tentative_g + h_value;
             generated++; // 新たに生成したノード数をカウント
-            open.push(Node{f_value, tentative_g, h_value, nxt}, f_value, h_value);
+            open.push(nxt, f_value, second_key(tentative_g, h_value));
         }
     }
 
@@ -131,6 +151,60 @@ A_star_path(const puzzle8::Puzzle& start,
     };
 }
 
+// 1 問だけ解くとき（作業領域をその場で作る）
+template <TieBreak Tie = TieBreak::Fifo, class H = puzzle8::ZeroHeuristic>
+inline SearchResult
+A_star_path(const puzzle8::Puzzle& start,
+            const puzzle8::Puzzle& goal,
+            H heur = H{}) {
+    SearchContext<Tie> ctx;
+    return A_star_path<Tie>(ctx, start, goal, heur);
+}
+
+// 距離表による最適解の取り出し（オラクル）
+// 全状態の最短手数が表にあるので、手数が 1 減る隣へ進むことを繰り返すだけで最適経路になる。
+// 目標盤面は Puzzle::goal() のみ対応。generated は調べた隣接盤面の数
+inline SearchResult
+oracle_path(const puzzle8::Puzzle& start,
+            const puzzle8::Puzzle& goal) {
+    using puzzle8::Puzzle;
+
+    auto t0 = std::chrono::steady_clock::now();
+    if (goal != Puzzle::goal()) {
+        throw std::invalid_argument("oracle_path supports only Puzzle::goal() as the goal");
+    }
+
+    SearchResult out;
+    if (!puzzle8::is_solvable(start, goal)) {
+        out.unsolvable = true;
+        return out;
+    }
+    const puzzle8::DistanceTable& table = puzzle8::distance_table();
+    int d = table.distance(start.board);
+    if (d >= 0) {
+        std::vector<Puzzle::Move> path;
+        path.reserve(d);
+        Puzzle s = start;
+        while (d > 0) {
+            for (Puzzle::Move m : sliding::MOVES) {
+                if (!Puzzle::can_move(s.zero_pos, m)) continue;
+                Puzzle nxt = s;
+                nxt.move_inplace(m);
+                ++out.generated;
+                if (table.dist[puzzle8::rank_board(nxt.board)] == d - 1) {
+                    path.push_back(m);
+                    s = nxt;
+                    --d;
+                    break;
+                }
+            }
+        }
+        out.path = std::move(path);
+    }
+    out.elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    return out;
+}
+
 inline std::string move_to_string(puzzle8::Puzzle::Move m) {
     switch (m) {
         case puzzle8::Puzzle::Move::Up:    return "Up";
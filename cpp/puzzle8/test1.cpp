@@ -1,5 +1,6 @@
 #include <random>
 #include <iostream>
+#include <chrono>
 #include "puzzle.hpp"
 #include "generator.hpp"
 #include "solver.hpp"
@@ -19,10 +20,25 @@ int main() {
 
     auto goal = puzzle8::Puzzle::goal(); // 目標状態
 
+    // 距離表（全 181,440 状態）の構築
+    auto tb0 = std::chrono::steady_clock::now();
+    const auto& table = puzzle8::distance_table();
+    auto tb1 = std::chrono::steady_clock::now();
+    std::cout << "Distance table: " << puzzle8::NUM_STATES << " states, max distance " << table.max_distance << ", built in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(tb1 - tb0).count() << " ms\n";
+    long long oracle_ns_total = 0; // オラクルの合計時間
+    long long a_star_ns_total = 0; // A* の合計時間（ms 単位の elapsed_ms では 0 になるので外から測る）
+
+    // A* の作業領域は 1 つを使い回す（2 問目からはほとんど確保しない）
+    solver::SearchContext<> ctx;
+
     for (int i = 0; i < num_tests; ++i) {
         int steps = std::uniform_int_distribution<int>(min_len, max_len)(rng); // 10から40のランダムな手数
         puzzle8::Puzzle p = puzzle8::generate_random_puzzle(steps, std::nullopt);
-        auto result = solver::A_star_path(p, goal, puzzle8::manhattan_heuristic);
+        auto ta0 = std::chrono::steady_clock::now();
+        auto result = solver::A_star_path(ctx, p, goal, puzzle8::ManhattanHeuristic{});
+        auto ta1 = std::chrono::steady_clock::now();
+        a_star_ns_total += std::chrono::duration_cast<std::chrono::nanoseconds>(ta1 - ta0).count();
         if (result.path) {
 
             // 解の経路が正しいか判定する
@@ -33,6 +49,17 @@ int main() {
             generated_total += result.generated;
             elapsed_total += result.elapsed_ms;
             path_length_total += result.path->size();
+
+            // 距離表から取り出した経路も最適（A* と同じ長さ）で正しいか確認する
+            auto to0 = std::chrono::steady_clock::now();
+            auto oracle = solver::oracle_path(p, goal);
+            auto to1 = std::chrono::steady_clock::now();
+            oracle_ns_total += std::chrono::duration_cast<std::chrono::nanoseconds>(to1 - to0).count();
+            if (!oracle.path || oracle.path->size() != result.path->size()
+                || !solver::validate_path(p, goal, *oracle.path, /*check_invariants_each_step=*/false)) {
+                std::cerr << "[ERROR] oracle path mismatch at i=" << i << "\n";
+                return 1;
+            }
         }
     }
 
@@ -40,7 +67,9 @@ int main() {
     std::cout << "The range of moves (moves taken to generate the initial board state): " << "from " << min_len << " to " << max_len << "\n";
     std::cout << "Average generated nodes: " << (generated_total / num_tests) << "\n";
     std::cout << "Average elapsed time: " << (elapsed_total / num_tests) << " ms\n";
+    std::cout << "A* average time: " << (a_star_ns_total / num_tests / 1000.0) << " us\n";
     std::cout << "Average path length: " << (path_length_total / num_tests) << "\n";
+    std::cout << "Oracle average time: " << (oracle_ns_total / num_tests / 1000.0) << " us\n";
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include "sliding_puzzle.hpp"
+
+// 複数の盤面をまとめて展開する（Structure of Arrays）
+//
+// 1 盤面ずつ slide_blank / unslide_blank するかわりに、N 個の盤面の後続状態を配列ごとに書き出す。
+// 後続状態は「盤面」「空白」「動いたタイル」… をそれぞれ別の配列に並べるので、
+// 評価器は盤面の配列だけを先頭から流して読める（evaluate_batch。AVX2 で数盤面ずつ評価できる）。
+//
+// 探索器側は
+//   1. 展開するノードを数十個まとめて取り出し
+//   2. expand_batch で後続状態をすべて生成し
+//   3. 重複を除いた残りだけを evaluate_batch でまとめて評価する
+// という順に使う（solver15::A_star_batch_path、bfs15::FrontierBfs）。
+
+namespace sliding {
+
+// 後続状態のバッファ（SoA）
+template <class P>
+struct SuccessorBatch {
+    using Storage = typename P::Storage;
+
+    std::vector<Storage> packed;   // 子の盤面
+    std::vector<uint8_t> zero;     // 子の空白の位置
+    std::vector<uint8_t> old_zero; // 親の空白の位置（= 動いたタイルの移動先）
+    std::vector<uint8_t> tile;     // 動いたタイル
+    std::vector<Move> move;        // 親からの手
+    std::vector<uint32_t> parent;  // 親の番号（expand_batch に渡した配列の添字）
+
+    std::size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    void clear() noexcept { count = 0; }
+
+    P board(std::size_t i) const noexcept {
+        P p;
+        p.packed = packed[i];
+        p.zero_pos = zero[i];
+        return p;
+    }
+
+    // 後ろに n 個分の領域を確保する（縮めない）
+    void grow(std::size_t n) {
+        if (packed.size() >= count + n) return;
+        const std::size_t cap = std::max(count + n, 2 * packed.size());
+        packed.resize(cap);
+        zero.resize(cap);
+        old_zero.resize(cap);
+        tile.resize(cap);
+        move.resize(cap);
+        parent.resize(cap);
+    }
+
+    // i 番目を残すものだけ前に詰める（keep(i) が false のものを捨てる）
+    template <class Keep>
+    void compact(Keep&& keep) {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!keep(i)) continue;
+            packed[n] = packed[i];
+            zero[n] = zero[i];
+            old_zero[n] = old_zero[i];
+            tile[n] = tile[i];
+            move[n] = move[i];
+            parent[n] = parent[i];
+            ++n;
+        }
+        count = n;
+    }
+
+    std::size_t count = 0; // 使っている要素数（配列の長さは容量）
+};
+
+// n 個の盤面 (packed[i], zero[i]) の後続状態をすべて out の後ろに追加する
+// 手の順序は Geometry::SUCCESSORS と同じ（親ごとに Up, Down, Left, Right のうち打てるもの）
+template <class P>
+inline void expand_batch(const typename P::Storage* packed,
+                         const uint8_t* zero,
+                         std::size_t n,
+                         SuccessorBatch<P>& out) {
+    using Policy = typename P::Policy;
+    out.grow(4 * n);
+    std::size_t k = out.count;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto& succ = P::Geometry::SUCCESSORS[zero[i]];
+        const auto parent = packed[i];
+        for (int j = 0; j < succ.count; ++j) {
+            const int to = succ.to[j];
+            const uint8_t t = Policy::get(parent, to);
+            auto child = parent;
+            Policy::slide(child, to, zero[i], t);
+            out.packed[k] = child;
+            out.zero[k] = static_cast<uint8_t>(to);
+            out.old_zero[k] = zero[i];
+            out.tile[k] = t;
+            out.move[k] = succ.move[j];
+            out.parent[k] = static_cast<uint32_t>(i);
+            ++k;
+        }
+    }
+    out.count = k;
+}
+
+// まとめて評価できる評価器の要件
+//   void evaluate_batch(const Storage* packed, const uint8_t* zero, std::size_t n, uint8_t* h)
+//     : n 個の盤面の h を h[0..n) に書く
+template <class H, class P, class = void>
+struct is_batch_heuristic : std::false_type {};
+
+template <class H, class P>
+struct is_batch_heuristic<H, P, std::void_t<
+    decltype(std::declval<H&>().evaluate_batch(std::declval<const typename P::Storage*>(),
+                                               std::declval<const uint8_t*>(), std::size_t{},
+                                               std::declval<uint8_t*>()))>> : std::true_type {};
+
+template <class H, class P>
+inline constexpr bool is_batch_heuristic_v = is_batch_heuristic<H, P>::value;
+
+} // namespace sliding
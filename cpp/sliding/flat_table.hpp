@@ -0,0 +1,200 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <optional>
+#include "sliding_puzzle.hpp"
+#include "search_stats.hpp"
+
+// A* 用のオープンアドレス法（線形探査）の状態テーブル
+//
+// キーは盤面の格納値 (Storage) そのもの。1 スロットに g, h, クローズドフラグ, 親からの手, 親の空白位置を詰める。
+// 親の盤面は保存しない（子の盤面で手を戻せば得られる）ので、15パズルでは 1 状態 16 バイトで済む。
+// unordered_map のようなノード確保もポインタの追跡もなく、探査は連続したスロットを順に見るだけ。
+//
+// 盤面には各値がちょうど一度ずつ現れるので、全ビット 0 の格納値はありえない。これを空きスロットの印にする。
+// 挿入でテーブルが伸びるとスロットへのポインタは無効になる。
+// スロットの中身は FlatTable<S> のテンプレート引数で差し替えられる（A* 用は StateSlot、FlatStateTable<Key> はその別名）。
+// SLIDING_SEARCH_STATS を有効にしたときは find / insert の探査長を数える（probe_stats()）。
+
+namespace sliding {
+
+// 線形探査用のハッシュ（下位ビットをよく混ぜる。std::hash<uint64_t> は恒等写像なので使わない）
+inline uint64_t mix_hash(uint64_t x) noexcept { // splitmix64 の最終段
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+inline uint64_t mix_hash(unsigned __int128 x) noexcept {
+    return mix_hash(static_cast<uint64_t>(x) ^ mix_hash(static_cast<uint64_t>(x >> 64)));
+}
+template <std::size_t N>
+inline uint64_t mix_hash(const std::array<uint8_t, N>& x) noexcept {
+    return mix_hash(static_cast<uint64_t>(StorageHash{}(x)));
+}
+
+// A* 用のスロット: g, h, クローズドフラグ, 親からの手, 親の空白位置
+template <class Key>
+struct StateSlot {
+    Key key;
+    uint8_t g;         // 実コスト
+    uint8_t h;         // ヒューリスティック値
+    uint8_t prev_zero; // 親の空白位置
+    uint8_t flags;     // bit0: クローズド, bit1: 親あり, bit2-3: 親からの手
+
+    bool closed() const noexcept { return flags & 1; }
+    void set_closed() noexcept { flags |= 1; }
+    std::optional<Move> move() const noexcept {
+        if (!(flags & 2)) return std::nullopt;
+        return static_cast<Move>((flags >> 2) & 3);
+    }
+    // 開いた状態として g, h, 親を書き換える（より短い経路が見つかったときの再オープンも同じ）
+    void assign(int g_, int h_, Move m, int prev_zero_) noexcept {
+        g = static_cast<uint8_t>(g_);
+        h = static_cast<uint8_t>(h_);
+        prev_zero = static_cast<uint8_t>(prev_zero_);
+        flags = static_cast<uint8_t>(2 | (static_cast<int>(m) << 2));
+    }
+};
+
+// スロットの型 S は盤面の格納値 key を持ち、全ビット 0 で初期化できること
+template <class S>
+class FlatTable {
+public:
+    using Slot = S;
+    using Key = decltype(S::key);
+
+    // capacity は 2 のべき乗に切り上げる
+    explicit FlatTable(std::size_t capacity = 1 << 16) {
+        std::size_t cap = 16;
+        while (cap < capacity) cap <<= 1;
+        slots_.assign(cap, Slot{});
+        mask_ = cap - 1;
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    std::size_t capacity() const noexcept { return slots_.size(); }
+    std::size_t memory_bytes() const noexcept { return slots_.size() * sizeof(Slot); }
+
+    // 探査長の集計（SLIDING_SEARCH_STATS が無効なら常に 0）
+    struct ProbeStats {
+        uint64_t probes = 0; // find / insert の回数
+        uint64_t steps = 0;  // 見たスロットの数の合計
+        uint64_t max = 0;    // 1 回で見たスロットの数の最大
+    };
+    const ProbeStats& probe_stats() const noexcept { return probe_stats_; }
+
+    // 全スロットを空にする（容量はそのまま。次の探索で同じくらい入れても伸ばし直さない）
+    // 使ったスロットが少なければそこだけを消すので、大きく伸びた表でも小さな探索のあとは安く済む
+    void clear() noexcept {
+        if (touched_all_) {
+            std::fill(slots_.begin(), slots_.end(), Slot{});
+        } else {
+            for (uint32_t i : touched_) slots_[i] = Slot{};
+        }
+        touched_.clear();
+        touched_all_ = false;
+        size_ = 0;
+        probe_stats_ = ProbeStats{};
+    }
+
+    Slot* find(const Key& key) noexcept {
+        const std::size_t home = mix_hash(key) & mask_;
+        for (std::size_t i = home;; i = (i + 1) & mask_) {
+            Slot& s = slots_[i];
+            if (s.key == key) {
+                count_probe(home, i);
+                return &s;
+            }
+            if (s.key == Key{}) {
+                count_probe(home, i);
+                return nullptr;
+            }
+        }
+    }
+
+    // key のスロットを返す。新しく作ったときは second = true（g, h, flags は 0）
+    std::pair<Slot*, bool> insert(const Key& key) {
+        if ((size_ + 1) * 4 > slots_.size() * 3) grow(); // 負荷率 3/4 まで
+        const std::size_t home = mix_hash(key) & mask_;
+        for (std::size_t i = home;; i = (i + 1) & mask_) {
+            Slot& s = slots_[i];
+            if (s.key == key) {
+                count_probe(home, i);
+                return {&s, false};
+            }
+            if (s.key == Key{}) {
+                count_probe(home, i);
+                s.key = key;
+                ++size_;
+                touch(i);
+                return {&s, true};
+            }
+        }
+    }
+
+    // slot を消し、後ろに続く同じ探査列のスロットを前に詰める（他のスロットへのポインタも無効になる）
+    void erase(Slot* slot) noexcept {
+        std::size_t hole = static_cast<std::size_t>(slot - slots_.data());
+        for (std::size_t j = (hole + 1) & mask_;; j = (j + 1) & mask_) {
+            const Slot& s = slots_[j];
+            if (s.key == Key{}) break;
+            const std::size_t home = mix_hash(s.key) & mask_;
+            // 本来の位置 home から j までの間に穴があれば、穴へ移しても探査で見つかる
+            if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+                slots_[hole] = s;
+                hole = j;
+            }
+        }
+        slots_[hole] = Slot{};
+        --size_;
+    }
+
+private:
+    void count_probe(std::size_t home, std::size_t end) noexcept {
+        if constexpr (SEARCH_STATS_ENABLED) {
+            const uint64_t steps = ((end - home) & mask_) + 1;
+            ++probe_stats_.probes;
+            probe_stats_.steps += steps;
+            if (steps > probe_stats_.max) probe_stats_.max = steps;
+        }
+    }
+
+    // clear で消すスロットを覚える（容量の 1/8 を超えたら覚えるのをやめて全体を消す）
+    // erase で詰めたスロットも、詰める前にどれかが使っていた位置なので覚えた中に入っている
+    void touch(std::size_t i) {
+        if (touched_all_) return;
+        if (touched_.size() < slots_.size() / 8) touched_.push_back(static_cast<uint32_t>(i));
+        else touched_all_ = true;
+    }
+
+    void grow() {
+        std::vector<Slot> old(slots_.size() * 2, Slot{});
+        old.swap(slots_);
+        mask_ = slots_.size() - 1;
+        for (const Slot& s : old) {
+            if (s.key == Key{}) continue;
+            std::size_t i = mix_hash(s.key) & mask_;
+            while (!(slots_[i].key == Key{})) i = (i + 1) & mask_;
+            slots_[i] = s;
+        }
+        touched_.clear();
+        touched_all_ = true; // 並べ直したので位置は覚えていない
+    }
+
+    std::vector<Slot> slots_;
+    std::size_t mask_ = 0;
+    std::size_t size_ = 0;
+    std::vector<uint32_t> touched_; // 前回の clear 以降に使い始めたスロット
+    bool touched_all_ = false;      // true なら clear で全体を消す
+    ProbeStats probe_stats_;
+};
+
+template <class Key>
+using FlatStateTable = FlatTable<StateSlot<Key>>;
+
+} // namespace sliding
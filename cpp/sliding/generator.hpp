@@ -0,0 +1,127 @@
+#pragma once
+#include <random>
+#include <optional>
+#include <utility>
+#include <array>
+#include <cstdint>
+#include "sliding_puzzle.hpp"
+#include "solvability.hpp"
+
+// 問題の生成（任意サイズ共通）
+// - random_walk      : 目標盤面からのランダムウォーク（手数で難しさを調整できる。確保なし）
+// - fast_random_walk : 同じく、乱数を splitmix64 にして速さを優先したもの（負荷試験用）
+// - random_solvable  : 目標盤面から行ける盤面を一様に選ぶ（セルの並びを一様に混ぜ、偶奇が合わなければ 2 タイルを入れ替える）
+
+namespace sliding {
+
+namespace detail {
+// WALK_MOVES<P>[空白の位置][直前の手（4 は無し）] = 直前の手の逆を除いた打てる手（順序は SUCCESSORS と同じ）
+template <class P>
+constexpr auto make_walk_moves() {
+    using Successors = typename P::Geometry::Successors;
+    std::array<std::array<Successors, 5>, P::CELLS> t{};
+    for (int z = 0; z < P::CELLS; ++z) {
+        const Successors& succ = P::Geometry::SUCCESSORS[z];
+        for (int last = 0; last <= 4; ++last) {
+            Successors& c = t[z][last];
+            for (int j = 0; j < succ.count; ++j) {
+                if (last < 4 && succ.move[j] == inverse_move(static_cast<Move>(last))) continue;
+                c.move[c.count] = succ.move[j];
+                c.to[c.count] = succ.to[j];
+                ++c.count;
+            }
+        }
+    }
+    return t;
+}
+template <class P>
+inline constexpr auto WALK_MOVES = make_walk_moves<P>();
+} // namespace detail
+
+// splitmix64（state を進めて 64 ビットを返す）
+inline uint64_t splitmix64(uint64_t& state) noexcept {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// start からのランダムウォークで盤面を作る
+// 目標盤面が P::goal() でないとき（Korf の問題集など）は、その目標盤面を start に渡す
+template <class P>
+inline P random_walk(
+    const P& start,
+    int n, // スライド操作の回数
+    std::mt19937& rng,
+    bool avoid_backtrack = true // 直前の手の逆を除外するか
+) {
+    const auto& table = detail::WALK_MOVES<P>;
+    P cur = start;
+    int last = 4; // 直前の手（4 は無し。avoid_backtrack でなければずっと 4）
+    for (int step = 0; step < n; ++step) {
+        const auto& cand = table[cur.zero_pos][last];
+        const int j = std::uniform_int_distribution<int>(0, cand.count - 1)(rng);
+        cur.slide_blank(cand.to[j]);
+        if (avoid_backtrack) last = static_cast<int>(cand.move[j]);
+    }
+    return cur;
+}
+
+// 目標状態 P::goal() からのランダムウォーク
+template <class P>
+inline P random_walk(int n, std::mt19937& rng, bool avoid_backtrack = true) {
+    return random_walk(P::goal(), n, rng, avoid_backtrack);
+}
+
+// 速さ優先のランダムウォーク（負荷試験用。直前の手の逆は打たない）
+// splitmix64 の 64 ビットを 16 ビットずつ 4 手に使う（手の選び方の偏りは 1 手あたり 3/65536 以下）。
+// random_walk とは乱数の使い方が違うので、同じシードでも同じ盤面にはならない
+template <class P>
+inline P fast_random_walk(const P& start, int n, uint64_t& state) noexcept {
+    const auto& table = detail::WALK_MOVES<P>;
+    P cur = start;
+    int last = 4;
+    uint64_t bits = 0;
+    int left = 0; // bits に残っている 16 ビットの数
+    for (int step = 0; step < n; ++step) {
+        if (left == 0) {
+            bits = splitmix64(state);
+            left = 4;
+        }
+        const auto& cand = table[cur.zero_pos][last];
+        const int j = static_cast<int>(((bits & 0xFFFF) * cand.count) >> 16);
+        bits >>= 16;
+        --left;
+        cur.slide_blank(cand.to[j]);
+        last = static_cast<int>(cand.move[j]);
+    }
+    return cur;
+}
+
+// goal から行ける盤面を一様に選ぶ
+// 格納値の上でセルを Fisher-Yates で混ぜ、偶奇が goal と違えば空白でない先頭の 2 セルを入れ替える。
+// 入れ替えは偶奇の違う盤面から合う盤面への全単射（空白の位置は変えない）なので、結果は行ける盤面の上で一様になる。
+template <class P>
+inline P random_solvable(std::mt19937& rng, const P& goal = P::goal()) {
+    using Policy = typename P::Policy;
+    P p = goal;
+    for (int i = P::CELLS - 1; i > 0; --i) {
+        const int j = std::uniform_int_distribution<int>(0, i)(rng);
+        const uint8_t a = Policy::get(p.packed, i);
+        const uint8_t b = Policy::get(p.packed, j);
+        Policy::set(p.packed, i, b);
+        Policy::set(p.packed, j, a);
+        if (a == 0) p.zero_pos = static_cast<uint8_t>(j);
+        else if (b == 0) p.zero_pos = static_cast<uint8_t>(i);
+    }
+    if (board_parity(p) != board_parity(goal)) {
+        const int a = p.zero_pos == 0 ? 1 : 0;
+        const int b = p.zero_pos == a + 1 ? a + 2 : a + 1;
+        const uint8_t ta = Policy::get(p.packed, a);
+        Policy::set(p.packed, a, Policy::get(p.packed, b));
+        Policy::set(p.packed, b, ta);
+    }
+    return p;
+}
+
+} // namespace sliding
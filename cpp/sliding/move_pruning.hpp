@@ -0,0 +1,229 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <string>
+#include <queue>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include "sliding_puzzle.hpp"
+
+// 有限オートマトンによる手順の枝刈り (Taylor & Korf)
+//
+// 空白の動かし方（手の列）の効果は、盤面の中身によらず空白がたどった経路の形だけで決まる。
+// そこで長さ max_len 以下の手の列を短い順（同じ長さなら辞書順）に列挙し、
+// 自分より小さい列で「同じ効果」かつ「動ける範囲が自分以下（小さい列も必ず打てる）」のものがあれば、
+// 自分を禁止列にする。禁止列を含む経路は、それを小さい列に置き換えた同じ長さ以下の経路が必ずあるので、
+// 探索から外しても最適解は失われない。
+//
+// 禁止列の集合を Aho-Corasick のオートマトンにして、探索では小さな状態番号を持ち回るだけで判定する。
+//   next(state, m) < 0 なら、その手を打つと禁止列が現れるので枝刈り
+// 長さ 2 の禁止列 (Up Down など) が直前手の巻き戻しに当たり、長さ 12 の 2x2 の回転などで経路上の
+// 短い閉路も消えるので、IDA* の経路上の盤面の集合（onpath_set）は要らなくなる。
+
+namespace sliding {
+
+template <int Rows, int Cols>
+class MovePruningFsm {
+public:
+    static constexpr int START = 0; // 初期状態
+
+    // 4x4 では長さ 12 まで（禁止列 1,900 本・6,868 状態、構築は最初に 1 回で 0.4 秒程度）。
+    // 14 にすると木はさらに 1 割ほど小さくなるが、表が L2 に収まらず 1 ノードあたりが遅くなる
+    static constexpr int DEFAULT_MAX_LEN = 12;
+
+    explicit MovePruningFsm(int max_len = DEFAULT_MAX_LEN) {
+        build(enumerate_forbidden(max_len));
+    }
+
+    // 状態 state で手 m を打ったあとの状態（禁止なら -1）
+    inline int next(int state, Move m) const noexcept {
+        return delta_[state][static_cast<int>(m)];
+    }
+
+    std::size_t num_states() const noexcept { return delta_.size(); }
+    std::size_t num_forbidden() const noexcept { return num_forbidden_; }
+
+    // 手順をたどって状態を求める（途中で禁止されたら -1）
+    int run(const Move* moves, int n, int state = START) const noexcept {
+        for (int i = 0; i < n && state >= 0; ++i) state = next(state, moves[i]);
+        return state;
+    }
+
+    // 盤面サイズごとに 1 つ（最初に使うときに構築する）
+    static const MovePruningFsm& instance() {
+        static const MovePruningFsm fsm;
+        return fsm;
+    }
+
+private:
+    std::vector<std::array<int32_t, 4>> delta_;
+    std::size_t num_forbidden_ = 0;
+
+    // 無限に広い盤面の上で空白を動かしたときの効果を調べる作業領域
+    struct Workspace {
+        static constexpr int W = 2 * 16 + 1; // max_len <= 16 の範囲
+        static constexpr int C = 16;         // 開始位置 (C, C)
+        std::array<int16_t, W * W> origin{}; // origin[セル] = そこにあるタイルの元のセル
+        int zr = C, zc = C;
+
+        Workspace() {
+            for (int i = 0; i < W * W; ++i) origin[i] = static_cast<int16_t>(i);
+        }
+
+        // 空白の移動先（dr, dc）
+        static constexpr int DR[4] = {-1, 1, 0, 0};
+        static constexpr int DC[4] = {0, 0, -1, 1};
+
+        void apply(int m) noexcept {
+            const int nr = zr + DR[m], nc = zc + DC[m];
+            std::swap(origin[zr * W + zc], origin[nr * W + nc]);
+            zr = nr;
+            zc = nc;
+        }
+
+        // 効果の署名: 空白の終点と、動いたセルの (位置, 元の位置) の列
+        std::string signature(int r0, int r1, int c0, int c1) const {
+            std::string sig;
+            sig.push_back(static_cast<char>(zr));
+            sig.push_back(static_cast<char>(zc));
+            for (int r = r0; r <= r1; ++r) {
+                for (int c = c0; c <= c1; ++c) {
+                    const int i = r * W + c;
+                    if (origin[i] == i) continue;
+                    sig.push_back(static_cast<char>(r));
+                    sig.push_back(static_cast<char>(c));
+                    sig.push_back(static_cast<char>(origin[i] / W));
+                    sig.push_back(static_cast<char>(origin[i] % W));
+                }
+            }
+            return sig;
+        }
+    };
+
+    struct Box { int r0, r1, c0, c1; };
+
+    // 手の列のキー: 1 手 2bit を下位から詰め、長さを上位に置く
+    static uint64_t key_of(uint64_t bits, int len) noexcept { return (static_cast<uint64_t>(len) << 40) | bits; }
+
+    // 禁止列を列挙する（長さごとの反復深化で、短い順・辞書順に調べる）
+    static std::vector<std::string> enumerate_forbidden(int max_len) {
+        if (max_len > 16) max_len = 16;
+        std::unordered_map<std::string, std::vector<Box>> seen; // 効果 → それを実現した列の範囲
+        std::unordered_set<uint64_t> forbidden; // key_of で引く
+        std::vector<std::string> forbidden_list;
+
+        Workspace ws;
+        seen[ws.signature(Workspace::C, Workspace::C, Workspace::C, Workspace::C)].push_back(
+            Box{Workspace::C, Workspace::C, Workspace::C, Workspace::C}); // 空列
+
+        std::string cur;
+        for (int len = 1; len <= max_len; ++len) {
+            struct Rec {
+                Workspace& ws;
+                std::string& cur;
+                std::unordered_map<std::string, std::vector<Box>>& seen;
+                std::unordered_set<uint64_t>& forbidden;
+                std::vector<std::string>& forbidden_list;
+                int len;
+                uint64_t bits = 0; // cur を 2bit ずつ詰めたもの
+
+                void operator()(Box box) {
+                    if (static_cast<int>(cur.size()) == len) {
+                        const std::string sig = ws.signature(box.r0, box.r1, box.c0, box.c1);
+                        auto& boxes = seen[sig];
+                        for (const Box& b : boxes) {
+                            if (box.r0 <= b.r0 && b.r1 <= box.r1 && box.c0 <= b.c0 && b.c1 <= box.c1) {
+                                forbidden.insert(key_of(bits, len));
+                                forbidden_list.push_back(cur);
+                                return;
+                            }
+                        }
+                        boxes.push_back(box);
+                        return;
+                    }
+                    for (int m = 0; m < 4; ++m) {
+                        const int nr = ws.zr + Workspace::DR[m], nc = ws.zc + Workspace::DC[m];
+                        const Box nb{std::min(box.r0, nr), std::max(box.r1, nr), std::min(box.c0, nc), std::max(box.c1, nc)};
+                        if (nb.r1 - nb.r0 >= Rows || nb.c1 - nb.c0 >= Cols) continue; // この盤面では打てない列
+
+                        cur.push_back(static_cast<char>('0' + m));
+                        const uint64_t prev_bits = bits;
+                        bits |= static_cast<uint64_t>(m) << (2 * (cur.size() - 1));
+                        // 伸ばした列の接尾辞に禁止列があれば、この列もその先も探索では現れない
+                        bool bad = false;
+                        const int n = static_cast<int>(cur.size());
+                        for (int k = 0; k < n && !bad; ++k) {
+                            if (forbidden.count(key_of(bits >> (2 * k), n - k))) bad = true;
+                        }
+                        if (!bad) {
+                            ws.apply(m);
+                            (*this)(nb);
+                            ws.apply(m ^ 1); // 逆向きの手で戻す (Up<->Down, Left<->Right)
+                        }
+                        bits = prev_bits;
+                        cur.pop_back();
+                    }
+                }
+            };
+            Rec{ws, cur, seen, forbidden, forbidden_list, len}(Box{Workspace::C, Workspace::C, Workspace::C, Workspace::C});
+        }
+        return forbidden_list;
+    }
+
+    // 禁止列から Aho-Corasick のオートマトンを作る
+    void build(const std::vector<std::string>& forbidden) {
+        num_forbidden_ = forbidden.size();
+        std::vector<std::array<int32_t, 4>> go(1, {-1, -1, -1, -1});
+        std::vector<char> terminal(1, 0);
+        for (const auto& s : forbidden) {
+            int v = 0;
+            for (char ch : s) {
+                const int m = ch - '0';
+                if (go[v][m] < 0) {
+                    go[v][m] = static_cast<int32_t>(go.size());
+                    go.push_back({-1, -1, -1, -1});
+                    terminal.push_back(0);
+                }
+                v = go[v][m];
+            }
+            terminal[v] = 1;
+        }
+
+        // 幅優先で失敗遷移を張り、遷移を完全な表にする
+        std::vector<int32_t> fail(go.size(), 0);
+        std::queue<int> q;
+        for (int m = 0; m < 4; ++m) {
+            if (go[0][m] < 0) go[0][m] = 0;
+            else q.push(go[0][m]);
+        }
+        while (!q.empty()) {
+            const int v = q.front();
+            q.pop();
+            if (terminal[fail[v]]) terminal[v] = 1; // 接尾辞が禁止列なら自分も禁止
+            for (int m = 0; m < 4; ++m) {
+                const int u = go[v][m];
+                if (u < 0) {
+                    go[v][m] = go[fail[v]][m];
+                } else {
+                    fail[u] = go[fail[v]][m];
+                    q.push(u);
+                }
+            }
+        }
+
+        // 禁止状態への遷移は -1 にし、禁止状態を取り除いて番号を詰める
+        std::vector<int32_t> id(go.size(), -1);
+        int n = 0;
+        for (std::size_t v = 0; v < go.size(); ++v) {
+            if (!terminal[v]) id[v] = n++;
+        }
+        delta_.assign(n, {-1, -1, -1, -1});
+        for (std::size_t v = 0; v < go.size(); ++v) {
+            if (terminal[v]) continue;
+            for (int m = 0; m < 4; ++m) delta_[id[v]][m] = id[go[v][m]];
+        }
+    }
+};
+
+} // namespace sliding
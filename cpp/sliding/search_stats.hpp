@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+
+// 探索の内訳の計測（コンパイル時に有効にしたときだけ数える）
+//
+// -DSLIDING_SEARCH_STATS=1 を付けてコンパイルすると、A* / IDA* が SearchResult::stats に
+// 展開・生成ノード数、重複で捨てた子、再オープン、オープンリストの最大長、状態表の負荷率と探査長、
+// 評価器の時間、IDA* の反復ごとのノード数と時間を書く。
+// 付けなければ数える処理はすべて if constexpr で消えるので、探索ループには何も残らない（stats は 0 のまま）。
+
+#ifndef SLIDING_SEARCH_STATS
+#define SLIDING_SEARCH_STATS 0
+#endif
+
+namespace sliding {
+
+inline constexpr bool SEARCH_STATS_ENABLED = SLIDING_SEARCH_STATS != 0;
+
+// 評価器の時間は SAMPLE 回に 1 回だけ測って全体に引き延ばす（毎回時計を読むと評価器より時計の方が重い）
+inline constexpr uint64_t HEURISTIC_TIMING_SAMPLE = 64;
+
+// IDA* の 1 反復
+struct IterationStats {
+    int bound = 0;          // 閾値
+    uint64_t expanded = 0;  // 子を試した節点の数
+    uint64_t generated = 0; // 評価した子の数
+    long long elapsed_ns = 0;
+};
+
+struct SearchStats {
+    uint64_t expanded = 0;   // 子を生成した節点の数
+    uint64_t generated = 0;  // 評価した子の数（閾値超過・重複で捨てた子も含む）
+    uint64_t duplicates = 0; // 重複として捨てた子（A*: g が小さくならない子と展開済みの取り出し、IDA*: オートマトンと置換表の枝刈り）
+    uint64_t reopened = 0;   // 閉じた状態をより短い経路で開き直した回数（A*）
+    std::size_t open_max = 0; // オープンリストの最大の長さ（A*）
+
+    // 状態表（A*）: 探索の終わりの要素数と容量、引いた回数と探査したスロット数
+    std::size_t table_size = 0;
+    std::size_t table_capacity = 0;
+    uint64_t table_probes = 0;
+    uint64_t table_probe_steps = 0;
+    uint64_t table_probe_max = 0;
+
+    // 評価器（reset / update）の呼び出し回数と、抜き取りで見積もった時間
+    uint64_t heuristic_calls = 0;
+    long long heuristic_ns = 0;
+
+    std::vector<IterationStats> iterations; // IDA* の反復ごと
+
+    double table_load() const noexcept {
+        return table_capacity ? static_cast<double>(table_size) / table_capacity : 0.0;
+    }
+    double mean_probe_length() const noexcept {
+        return table_probes ? static_cast<double>(table_probe_steps) / table_probes : 0.0;
+    }
+
+    std::string to_string() const {
+        std::ostringstream oss;
+        oss << "expanded " << expanded << ", generated " << generated << ", duplicates " << duplicates
+            << ", reopened " << reopened << ", open max " << open_max << "\n";
+        if (table_capacity) {
+            oss << "table " << table_size << " / " << table_capacity << " (load " << table_load()
+                << "), probes " << table_probes << ", mean probe length " << mean_probe_length() << ", max "
+                << table_probe_max << "\n";
+        }
+        oss << "heuristic calls " << heuristic_calls << ", about " << heuristic_ns / 1000 << " us\n";
+        for (const auto& it : iterations) {
+            oss << "  bound " << it.bound << ": expanded " << it.expanded << ", generated " << it.generated << ", "
+                << it.elapsed_ns / 1000 << " us\n";
+        }
+        return oss.str();
+    }
+};
+
+// 時計を 2 回続けて読むのにかかる時間 (ns)。評価器の 1 回は数 ns なので、測った時間からこれを引く
+inline long long clock_overhead_ns() {
+    static const long long overhead = [] {
+        long long best = std::numeric_limits<long long>::max();
+        for (int i = 0; i < 1000; ++i) {
+            const auto t0 = std::chrono::steady_clock::now();
+            const auto t1 = std::chrono::steady_clock::now();
+            best = std::min<long long>(best, std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        }
+        return best;
+    }();
+    return overhead;
+}
+
+// 評価器の呼び出しを数え、SAMPLE 回に 1 回だけ時間を測る
+// 計測が無効なら f() を呼ぶだけ
+template <class F>
+inline auto timed_heuristic(SearchStats& stats, F&& f) {
+    if constexpr (SEARCH_STATS_ENABLED) {
+        if (stats.heuristic_calls++ % HEURISTIC_TIMING_SAMPLE == 0) {
+            const long long overhead = clock_overhead_ns();
+            const auto t0 = std::chrono::steady_clock::now();
+            auto r = f();
+            const auto t1 = std::chrono::steady_clock::now();
+            const long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() - overhead;
+            stats.heuristic_ns += static_cast<long long>(HEURISTIC_TIMING_SAMPLE) * std::max(ns, 0LL);
+            return r;
+        }
+    }
+    return f();
+}
+
+} // namespace sliding
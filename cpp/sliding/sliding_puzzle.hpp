@@ -0,0 +1,321 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <optional>
+#include <sstream>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+// Rows×Cols のスライディングパズルの共通コア
+//
+// - 盤面の形 (行・列・隣接セル) はコンパイル時の定数表 Grid<Rows, Cols> にまとめる
+// - 盤面の格納方法はセル数で切り替える (StoragePolicy)
+//     16 セル以下 : uint64_t に 4bit ずつ (8パズル, 15パズル)
+//     25 セル以下 : unsigned __int128 に 5bit ずつ (24パズル)
+//     それ以上    : 1 セル 1 バイトの配列
+// - puzzle15::Puzzle は SlidingPuzzle<4, 4> そのもの、puzzle8 は Grid<3, 3> と同じ格納方法を使う
+
+namespace sliding {
+
+enum class Move : uint8_t { Up = 0, Down = 1, Left = 2, Right = 3 };
+
+inline constexpr Move MOVES[4] = {Move::Up, Move::Down, Move::Left, Move::Right};
+
+static constexpr inline Move inverse_move(Move m) noexcept {
+    switch (m) {
+        case Move::Up:    return Move::Down;
+        case Move::Down:  return Move::Up;
+        case Move::Left:  return Move::Right;
+        case Move::Right: return Move::Left;
+    }
+    return Move::Up; // 到達不能
+}
+
+// 盤面の形に関する定数表
+template <int Rows, int Cols>
+struct Grid {
+    static constexpr int ROWS = Rows;
+    static constexpr int COLS = Cols;
+    static constexpr int CELLS = Rows * Cols;
+
+    static constexpr int row(int idx) noexcept { return idx / Cols; }
+    static constexpr int col(int idx) noexcept { return idx % Cols; }
+    static constexpr int idx(int r, int c) noexcept { return r * Cols + c; }
+
+    // NEIGHBOR[空白の位置][手] = 空白の移動先（動かせないなら -1）
+    static constexpr std::array<std::array<int8_t, 4>, CELLS> make_neighbor() {
+        std::array<std::array<int8_t, 4>, CELLS> t{};
+        for (int i = 0; i < CELLS; ++i) {
+            const int r = row(i), c = col(i);
+            t[i][0] = static_cast<int8_t>(r > 0        ? i - Cols : -1);
+            t[i][1] = static_cast<int8_t>(r < Rows - 1 ? i + Cols : -1);
+            t[i][2] = static_cast<int8_t>(c > 0        ? i - 1    : -1);
+            t[i][3] = static_cast<int8_t>(c < Cols - 1 ? i + 1    : -1);
+        }
+        return t;
+    }
+    static constexpr std::array<std::array<int8_t, 4>, CELLS> NEIGHBOR = make_neighbor();
+
+    static constexpr int target(int zero, Move m) noexcept {
+        return NEIGHBOR[zero][static_cast<int>(m)];
+    }
+
+    // SUCCESSORS[空白の位置] = 打てる手と空白の移動先の一覧（探索の内側のループで盤面の端を判定しないため）
+    struct Successors {
+        uint8_t count = 0;
+        std::array<Move, 4> move{};
+        std::array<int8_t, 4> to{};
+    };
+    static constexpr std::array<Successors, CELLS> make_successors() {
+        std::array<Successors, CELLS> t{};
+        for (int i = 0; i < CELLS; ++i) {
+            for (int m = 0; m < 4; ++m) {
+                if (NEIGHBOR[i][m] < 0) continue;
+                t[i].move[t[i].count] = static_cast<Move>(m);
+                t[i].to[t[i].count] = NEIGHBOR[i][m];
+                ++t[i].count;
+            }
+        }
+        return t;
+    }
+    static constexpr std::array<Successors, CELLS> SUCCESSORS = make_successors();
+
+    // 最適解の長さの上限（IDA* の経路配列やバケットの範囲に使う）
+    // 8パズル: 31, 15パズル: 80 は最長の最適解の長さ, 24パズル: 205 は証明済みの上界。それ以外は粗い上界
+    static constexpr int MAX_DEPTH =
+        (Rows == 3 && Cols == 3) ? 31 :
+        (Rows == 4 && Cols == 4) ? 80 :
+        (Rows == 5 && Cols == 5) ? 205 : CELLS * (Rows + Cols);
+};
+
+// 格納方法: BITS ビットずつ整数に詰める
+template <class Word, int Bits>
+struct PackedStorage {
+    using type = Word;
+    static constexpr int BITS = Bits;
+    static constexpr Word MASK = (Word(1) << Bits) - 1;
+
+    static inline uint8_t get(const Word& x, int idx) noexcept {
+        return static_cast<uint8_t>((x >> (idx * Bits)) & MASK);
+    }
+    static inline void set(Word& x, int idx, uint8_t v) noexcept {
+        const Word mask = MASK << (idx * Bits);
+        x = (x & ~mask) | ((static_cast<Word>(v) & MASK) << (idx * Bits));
+    }
+    // 値 v を from から空きセル to（値 0）へ移す。足し引きだけで済む
+    static inline void slide(Word& x, int from, int to, uint8_t v) noexcept {
+        x += (static_cast<Word>(v) << (to * Bits)) - (static_cast<Word>(v) << (from * Bits));
+    }
+};
+
+// 格納方法: 1 セル 1 バイトの配列
+template <int Cells>
+struct ByteStorage {
+    using type = std::array<uint8_t, Cells>;
+    static constexpr int BITS = 8;
+
+    static inline uint8_t get(const type& x, int idx) noexcept { return x[idx]; }
+    static inline void set(type& x, int idx, uint8_t v) noexcept { x[idx] = v; }
+    static inline void slide(type& x, int from, int to, uint8_t v) noexcept {
+        x[to] = v;
+        x[from] = 0;
+    }
+};
+
+template <int Cells>
+using StoragePolicy = std::conditional_t<
+    (Cells <= 16), PackedStorage<uint64_t, 4>,
+    std::conditional_t<(Cells <= 25), PackedStorage<unsigned __int128, 5>, ByteStorage<Cells>>>;
+
+// unordered_* 用のハッシュ（格納方法ごと）
+struct StorageHash {
+    std::size_t operator()(uint64_t x) const noexcept { return std::hash<uint64_t>{}(x); }
+    std::size_t operator()(unsigned __int128 x) const noexcept {
+        const uint64_t lo = static_cast<uint64_t>(x), hi = static_cast<uint64_t>(x >> 64);
+        return std::hash<uint64_t>{}(lo ^ (hi * 0x9E3779B97F4A7C15ULL));
+    }
+    template <std::size_t N>
+    std::size_t operator()(const std::array<uint8_t, N>& x) const noexcept {
+        uint64_t h = 0xcbf29ce484222325ULL; // FNV-1a
+        for (uint8_t v : x) h = (h ^ v) * 0x100000001b3ULL;
+        return static_cast<std::size_t>(h);
+    }
+};
+
+template <int Rows, int Cols>
+struct SlidingPuzzle {
+    using Geometry = Grid<Rows, Cols>;
+    using Policy = StoragePolicy<Rows * Cols>;
+    using Storage = typename Policy::type;
+    using Move = sliding::Move;
+
+    static constexpr int ROWS = Rows;
+    static constexpr int COLS = Cols;
+    static constexpr int CELLS = Rows * Cols;
+
+    Storage packed{};
+    uint8_t zero_pos = 0; // 空白の位置
+
+    // セル値の取り出し・書き込み（4x4 以下では 4bit ニブル）
+    static inline uint8_t nibble(const Storage& x, int idx) noexcept { return Policy::get(x, idx); }
+    static inline void set_nibble(Storage& x, int idx, uint8_t v) noexcept { Policy::set(x, idx, v); }
+    inline uint8_t get(int idx) const noexcept { return nibble(packed, idx); }
+    inline void    set(int idx, uint8_t v) noexcept { set_nibble(packed, idx, v); }
+
+    // goal の生成（1..CELLS-1 を順に並べ、空白は最後）
+    static inline SlidingPuzzle goal() noexcept {
+        SlidingPuzzle g;
+        for (int i = 0; i < CELLS - 1; ++i) set_nibble(g.packed, i, static_cast<uint8_t>(i + 1));
+        set_nibble(g.packed, CELLS - 1, 0);
+        g.zero_pos = static_cast<uint8_t>(CELLS - 1);
+        return g;
+    }
+
+    // タイル列から作る（空白は 0）
+    static inline SlidingPuzzle from_tiles(const std::array<uint8_t, CELLS>& tiles) noexcept {
+        SlidingPuzzle p;
+        for (int i = 0; i < CELLS; ++i) {
+            set_nibble(p.packed, i, tiles[i]);
+            if (tiles[i] == 0) p.zero_pos = static_cast<uint8_t>(i);
+        }
+        return p;
+    }
+
+    bool operator==(const SlidingPuzzle& other) const noexcept { return packed == other.packed; }
+    bool operator!=(const SlidingPuzzle& other) const noexcept { return !(*this == other); }
+
+    std::string to_string() const {
+        std::ostringstream oss;
+        for (int i = 0; i < CELLS; ++i) {
+            if (i && i % Cols == 0) oss << '\n';
+            const int v = get(i);
+            if (v == 0) oss << "  _";
+            else oss << (v < 10 ? "  " : " ") << v;
+        }
+        return oss.str();
+    }
+
+    // 位置 → (row,col)
+    static constexpr int row(int idx) noexcept { return Geometry::row(idx); }
+    static constexpr int col(int idx) noexcept { return Geometry::col(idx); }
+
+    static inline bool can_move(int zero, Move m) noexcept { return Geometry::target(zero, m) >= 0; }
+
+    // 方向の反転
+    static constexpr Move inverse(Move m) noexcept { return inverse_move(m); }
+
+    // 空白を動かした盤面を返す
+    std::optional<SlidingPuzzle> moved(Move m) const noexcept {
+        const int to = Geometry::target(zero_pos, m);
+        if (to < 0) return std::nullopt;
+        SlidingPuzzle q = *this;
+        const uint8_t t = nibble(q.packed, to);
+        set_nibble(q.packed, to, 0);
+        set_nibble(q.packed, zero_pos, t);
+        q.zero_pos = static_cast<uint8_t>(to);
+        return q;
+    }
+
+    inline std::vector<std::pair<SlidingPuzzle, Move>> neighbors() const {
+        std::vector<std::pair<SlidingPuzzle, Move>> out;
+        out.reserve(4);
+        for (Move m : MOVES) {
+            if (auto q = moved(m)) out.emplace_back(*q, m);
+        }
+        return out;
+    }
+
+    // 固定長buffer版の neighbors 関数
+    inline int neighbors_into(std::array<std::pair<SlidingPuzzle, Move>, 4>& buf) const noexcept {
+        int n = 0;
+        for (Move m : MOVES) {
+            if (auto q = moved(m)) buf[n++] = {*q, m};
+        }
+        return n;
+    }
+
+    inline bool apply_move_inplace(Move m, uint8_t& moved_tile, uint8_t& old_zero) noexcept {
+        const int to = Geometry::target(zero_pos, m);
+        if (to < 0) return false; // 移動できない場合
+
+        old_zero = zero_pos; // 元のゼロ位置を保存
+        moved_tile = nibble(packed, to); // 移動するタイルの値を保存
+
+        set_nibble(packed, to, 0);
+        set_nibble(packed, old_zero, moved_tile);
+        zero_pos = static_cast<uint8_t>(to);
+        return true;
+    }
+
+    // 空白を隣のセル to へ動かし、動いたタイルを返す（to が隣であることは呼び出し側が保証する）
+    // Geometry::SUCCESSORS と組み合わせて、端の判定なしで手を打つ
+    inline uint8_t slide_blank(int to) noexcept {
+        const uint8_t t = nibble(packed, to);
+        Policy::slide(packed, to, zero_pos, t);
+        zero_pos = static_cast<uint8_t>(to);
+        return t;
+    }
+    // slide_blank を戻す（空白を old_zero へ戻し、タイル t を元のセルへ）
+    inline void unslide_blank(uint8_t t, int old_zero) noexcept {
+        Policy::slide(packed, old_zero, zero_pos, t);
+        zero_pos = static_cast<uint8_t>(old_zero);
+    }
+
+    inline void undo_move_inplace(uint8_t moved_tile, uint8_t old_zero) noexcept {
+        const int to = zero_pos; // 現在のゼロ位置
+        set_nibble(packed, old_zero, 0); // 元のゼロ位置を空白に戻す
+        set_nibble(packed, to, moved_tile); // 現在のゼロ位置にタイルを戻す
+        zero_pos = old_zero; // ゼロ位置を更新
+    }
+};
+
+// 差分評価器の要件（探索器はこれを満たす型をテンプレート引数に取り、評価値の計算を探索ループにインライン展開する）
+//   int  reset(const P& s)                        : 盤面 s の h を全計算し、内部状態を s に合わせる
+//   int  update(int h, uint8_t t, int from, int to) : タイル t が from → to へ動いた（空白は to → from）ときの h
+//   void undo(uint8_t t, int from, int to)          : update で変えた内部状態を戻す
+// 手の向きは from と to から決まるので引数には取らない
+template <class H, class P, class = void>
+struct is_incremental_heuristic : std::false_type {};
+
+template <class H, class P>
+struct is_incremental_heuristic<H, P, std::void_t<
+    decltype(static_cast<int>(std::declval<H&>().reset(std::declval<const P&>()))),
+    decltype(static_cast<int>(std::declval<H&>().update(0, uint8_t{}, 0, 0))),
+    decltype(std::declval<H&>().undo(uint8_t{}, 0, 0))>> : std::true_type {};
+
+template <class H, class P>
+inline constexpr bool is_incremental_heuristic_v = is_incremental_heuristic<H, P>::value;
+
+// 任意の目標盤面に対するマンハッタン距離の差分評価器（24パズルなど専用表を持たない盤面用）
+template <class P>
+struct ManhattanHeuristic {
+    std::array<std::array<uint8_t, P::CELLS>, P::CELLS> dist{}; // [タイル][位置]
+
+    ManhattanHeuristic() : ManhattanHeuristic(P::goal()) {}
+    explicit ManhattanHeuristic(const P& goal) {
+        for (int g = 0; g < P::CELLS; ++g) {
+            const int t = goal.get(g);
+            if (t == 0) continue;
+            for (int pos = 0; pos < P::CELLS; ++pos) {
+                const int dr = P::row(g) - P::row(pos), dc = P::col(g) - P::col(pos);
+                dist[t][pos] = static_cast<uint8_t>((dr < 0 ? -dr : dr) + (dc < 0 ? -dc : dc));
+            }
+        }
+    }
+
+    inline int reset(const P& s) const noexcept {
+        int d = 0;
+        for (int pos = 0; pos < P::CELLS; ++pos) d += dist[s.get(pos)][pos];
+        return d;
+    }
+    inline int update(int h, uint8_t t, int oldPos, int newPos) const noexcept {
+        return h - dist[t][oldPos] + dist[t][newPos];
+    }
+    inline void undo(uint8_t, int, int) const noexcept {}
+};
+
+} // namespace sliding
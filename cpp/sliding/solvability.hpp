@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include "sliding_puzzle.hpp"
+
+// 盤面の偶奇（どの盤面からどの盤面へ行けるか）
+//
+// 1 手は空白とタイルの互換なので、セルの並び（空白も 0 として含める）の置換の偶奇が反転し、
+// 同時に空白の (行 + 列) の偶奇も反転する。2 つの偶奇の排他的論理和は手を打っても変わらない。
+// 2x2 以上の長方形の盤面では、この値が等しい 2 つの盤面は互いに行き来でき、異なれば行き来できない。
+
+namespace sliding {
+
+// セルの並びの置換の偶奇（転倒数の偶奇）。先に現れた大きい値をビット集合の popcount で数える
+template <class P>
+inline int permutation_parity(const P& p) noexcept {
+    static_assert(P::CELLS <= 32, "seen set is a uint32_t");
+    uint32_t seen = 0;
+    int inversions = 0;
+    for (int i = 0; i < P::CELLS; ++i) {
+        const int v = p.get(i);
+        inversions += __builtin_popcount(seen >> v); // v より大きい値（v 自身はまだ入っていない）
+        seen |= 1u << v;
+    }
+    return inversions & 1;
+}
+
+// 手を打っても変わらない偶奇（0 か 1）
+template <class P>
+inline int board_parity(const P& p) noexcept {
+    const int r = P::Geometry::row(p.zero_pos);
+    const int c = P::Geometry::col(p.zero_pos);
+    return permutation_parity(p) ^ ((r + c) & 1);
+}
+
+// start から goal へ行けるか
+template <class P>
+inline bool is_solvable(const P& start, const P& goal = P::goal()) noexcept {
+    return board_parity(start) == board_parity(goal);
+}
+
+} // namespace sliding
@@ -0,0 +1,89 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "flat_table.hpp"
+
+// IDA* 用の固定サイズの置換表（情報が失われてもよい、lossy な表）
+//
+// 盤面をキーに「今の反復でその盤面に到達した g とオートマトンの状態」を覚えておき、
+// 同じ反復でもう一度到達したとき
+//   - 前回の g の方が小さい                     → 枝刈り（前回の方が浅いので、その下はすでに探した）
+//   - g が同じで、オートマトンの状態も同じ      → 枝刈り（同じ条件で同じ部分木をすでに探した）
+// とする。オートマトンの状態が違うと打てる手順が違うので、g が同じでも枝刈りしない。
+// 表が埋まったら上書きする（枝刈りが減るだけで、解の最適性は変わらない）。
+//
+// 1 バケット = 4 エントリ（15パズルでは 16 バイト × 4 = 64 バイトのキャッシュライン 1 本）。
+// 置き換えるのは、古い反復のエントリ → g が最も大きい（枝刈りできる部分木が小さい）エントリの順。
+
+namespace sliding {
+
+template <class Key>
+class TranspositionTable {
+public:
+    struct Entry {
+        Key key;
+        uint16_t iteration; // 書き込んだ反復（0 は空）
+        uint16_t fsm_state; // オートマトンの状態
+        uint8_t g;
+    };
+    static constexpr int WAYS = 4;
+    struct alignas(64) Bucket {
+        std::array<Entry, WAYS> e;
+    };
+
+    // size_mb メガバイト以内で、バケット数が 2 のべき乗になるように確保する
+    explicit TranspositionTable(std::size_t size_mb) {
+        const std::size_t bytes = size_mb << 20;
+        std::size_t n = 1;
+        while (n * 2 * sizeof(Bucket) <= bytes) n <<= 1;
+        buckets_.assign(n, Bucket{});
+        mask_ = n - 1;
+    }
+
+    std::size_t memory_bytes() const noexcept { return buckets_.size() * sizeof(Bucket); }
+
+    // 反復を始めるたびに呼ぶ（前の反復のエントリは無効になる）
+    void new_iteration() noexcept {
+        if (++iteration_ == 0) { // 一周したら表を消して 1 からやり直す
+            buckets_.assign(buckets_.size(), Bucket{});
+            iteration_ = 1;
+        }
+    }
+
+    // probe_and_store の前に、バケットのキャッシュラインを読み込み始めておく
+    void prefetch(const Key& key) const noexcept {
+        __builtin_prefetch(&buckets_[mix_hash(key) & mask_]);
+    }
+
+    // 枝刈りできるなら true。できないなら今回の到達を記録して false
+    bool probe_and_store(const Key& key, int g, int fsm_state) noexcept {
+        Bucket& b = buckets_[mix_hash(key) & mask_];
+        Entry* victim = &b.e[0];
+        for (Entry& e : b.e) {
+            if (e.iteration == iteration_ && e.key == key) {
+                if (e.g < g || (e.g == g && e.fsm_state == fsm_state)) return true;
+                e.g = static_cast<uint8_t>(g);
+                e.fsm_state = static_cast<uint16_t>(fsm_state);
+                return false;
+            }
+            // 置き換え先: 古い反復のエントリを優先し、次に g が大きいもの
+            const bool e_stale = (e.iteration != iteration_);
+            const bool v_stale = (victim->iteration != iteration_);
+            if ((e_stale && !v_stale) || (e_stale == v_stale && e.g > victim->g)) victim = &e;
+        }
+        victim->key = key;
+        victim->iteration = iteration_;
+        victim->fsm_state = static_cast<uint16_t>(fsm_state);
+        victim->g = static_cast<uint8_t>(g);
+        return false;
+    }
+
+private:
+    std::vector<Bucket> buckets_;
+    std::size_t mask_ = 0;
+    uint16_t iteration_ = 0;
+};
+
+} // namespace sliding
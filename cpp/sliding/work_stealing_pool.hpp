@@ -0,0 +1,143 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <cstddef>
+#include <cstdint>
+
+// ワークスティーリング方式のスレッドプール
+//
+// run(n, fn) で仕事 0..n-1 を各ワーカーの両端キューに連続した塊で配り、fn(ワーカー番号, 仕事番号) を呼ぶ。
+// 自分のキューは後ろから取り出し、空になったら他のワーカーのキューの前から盗む。
+// 仕事の途中で新しい仕事は増えないので、全キューが空なら終わり。
+// 呼び出したスレッドもワーカー 0 として働き、全部の仕事が終わるまで戻らない。
+// スレッドはプールの寿命の間使い回す（IDA* の反復ごと・問題ごとに作り直さない）。
+
+namespace sliding {
+
+class WorkStealingPool {
+public:
+    // threads = 0 なら std::thread::hardware_concurrency()
+    explicit WorkStealingPool(unsigned threads = 0) {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+        for (unsigned w = 0; w < threads; ++w) queues_.push_back(std::make_unique<Queue>());
+        for (unsigned w = 1; w < threads; ++w) workers_.emplace_back([this, w] { loop(w); });
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            quit_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    unsigned size() const noexcept { return static_cast<unsigned>(queues_.size()); }
+
+    // 仕事の中で投げられた例外は、最初の一つを run の呼び出し元へ投げ直す
+    template <class F>
+    void run(std::size_t n, F&& fn) {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            job_ = std::forward<F>(fn);
+            error_ = nullptr;
+            const std::size_t W = queues_.size();
+            for (std::size_t w = 0; w < W; ++w) {
+                auto& q = *queues_[w];
+                std::lock_guard<std::mutex> qlk(q.m);
+                for (std::size_t t = n * w / W; t < n * (w + 1) / W; ++t) q.tasks.push_back(t);
+            }
+            busy_ = static_cast<unsigned>(workers_.size());
+            ++generation_;
+        }
+        start_cv_.notify_all();
+
+        work(0);
+
+        std::unique_lock<std::mutex> lk(m_);
+        done_cv_.wait(lk, [&] { return busy_ == 0; });
+        job_ = nullptr;
+        if (error_) std::rethrow_exception(error_);
+    }
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<std::size_t> tasks;
+    };
+
+    // 自分のキューの後ろ → 他のキューの前 の順に仕事を探す
+    bool pop(unsigned w, std::size_t& task) {
+        {
+            auto& q = *queues_[w];
+            std::lock_guard<std::mutex> lk(q.m);
+            if (!q.tasks.empty()) {
+                task = q.tasks.back();
+                q.tasks.pop_back();
+                return true;
+            }
+        }
+        const unsigned W = size();
+        for (unsigned i = 1; i < W; ++i) {
+            auto& q = *queues_[(w + i) % W];
+            std::lock_guard<std::mutex> lk(q.m);
+            if (!q.tasks.empty()) {
+                task = q.tasks.front();
+                q.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(unsigned w) {
+        std::size_t task;
+        while (pop(w, task)) {
+            try {
+                job_(w, task);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(m_);
+                if (!error_) error_ = std::current_exception();
+            }
+        }
+    }
+
+    void loop(unsigned w) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(m_);
+                start_cv_.wait(lk, [&] { return quit_ || generation_ != seen; });
+                if (quit_) return;
+                seen = generation_;
+            }
+            work(w);
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                if (--busy_ == 0) done_cv_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_; // queues_[w] はワーカー w のキュー
+    std::vector<std::thread> workers_;           // ワーカー 1.. のスレッド（0 は run の呼び出し元）
+    std::mutex m_;
+    std::condition_variable start_cv_, done_cv_;
+    std::function<void(unsigned, std::size_t)> job_;
+    std::exception_ptr error_;
+    uint64_t generation_ = 0; // run のたびに増える
+    unsigned busy_ = 0;       // まだ仕事中のワーカー 1.. の数
+    bool quit_ = false;
+};
+
+} // namespace sliding